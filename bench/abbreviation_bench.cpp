@@ -0,0 +1,45 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+constexpr size_t OPTION_COUNT = 1000;
+
+void bench_lookup(bool allow_abbreviations, const std::vector<std::string>& names, const std::vector<std::string>& arguments, const char* label) {
+    ArgParser parser("Bench");
+    parser.set_allow_abbreviations(allow_abbreviations);
+
+    for (const std::string& name : names) {
+        parser.add_int_argument(name.c_str()).mark_multi_value();
+    }
+
+    std::vector<std::string_view> argument_views(arguments.begin(), arguments.end());
+    parser.parse(argument_views);
+
+    Bench::Result result = Bench::measure(100, [&] {
+        parser.parse(argument_views);
+    });
+    Bench::report(label, arguments.size() - 1, result);
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        names.push_back("option-" + std::to_string(i * 7919 % 100000) + "-name");
+    }
+
+    std::vector<std::string> arguments = {"app"};
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        arguments.push_back("--" + names[i * 31 % OPTION_COUNT] + "=1");
+    }
+
+    bench_lookup(false, names, arguments, "1k options, exact linear lookup");
+    bench_lookup(true, names, arguments, "1k options, trie lookup");
+
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include <argparser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <sstream>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+// Hostile command lines against the O(total token bytes + number of arguments) bound of ArgParser::parse.
+// Every scenario is measured at sizes 4 times apart, taking the fastest of several parses per
+// size so that one descheduled or page-faulting run does not count. The program fails if the
+// slope of log(time) over log(bytes and arguments), fitted over all sizes, exceeds MAX_SLOPE:
+// linear paths fit about 1 even when falling out of cache, quadratic ones about 2.
+namespace {
+
+constexpr double MAX_SLOPE = 1.5;
+constexpr double SECONDS_PER_SIZE = 0.2;
+constexpr size_t MIN_RUNS = 5;
+// A single parse slower than this is superlinear beyond doubt; larger sizes are not tried.
+constexpr double MAX_SECONDS_PER_RUN = 5;
+
+struct Input {
+    std::unique_ptr<ArgParser> parser;
+    std::vector<std::string> arguments;
+    // Argument names are not copied by the parser.
+    std::deque<std::string> names;
+    size_t option_count = 0;
+
+    Input() : parser(std::make_unique<ArgParser>("Bench")) {
+        this->arguments.push_back("app");
+    }
+
+    const char* add_name(std::string name) {
+        return this->names.emplace_back(std::move(name)).c_str();
+    }
+
+    size_t get_work() const {
+        size_t work = this->option_count;
+        for (const std::string& argument : this->arguments) {
+            work += argument.size();
+        }
+
+        return work;
+    }
+};
+
+typedef std::function<void(Input&, size_t)> Scenario;
+
+// "-abcabc...": one flag lookup and one value per character.
+void make_short_cluster(Input& input, size_t size) {
+    input.parser->add_flag('a', "alpha");
+    input.parser->add_flag('b', "beta");
+    input.parser->add_flag('c', "gamma");
+    input.option_count = 3;
+
+    std::string cluster = "-";
+    for (size_t i = 0; i < size; i++) {
+        cluster += "abc"[i % 3];
+    }
+
+    input.arguments.push_back(std::move(cluster));
+}
+
+// "--name=xxx...": one huge value.
+void make_huge_value(Input& input, size_t size) {
+    input.parser->add_string_argument("name");
+    input.option_count = 1;
+    input.arguments.push_back("--name=" + std::string(size, 'x'));
+}
+
+// "--nnn...": one huge unknown name.
+void make_huge_name(Input& input, size_t size) {
+    input.parser->add_string_argument("name");
+    input.option_count = 1;
+    input.arguments.push_back("--" + std::string(size, 'n'));
+}
+
+// "--name====..." and "-s====...": values made of '=' signs.
+void make_equals_signs(Input& input, size_t size) {
+    input.parser->add_string_argument('s', "name");
+    input.option_count = 1;
+    input.arguments.push_back("--name" + std::string(size / 2, '='));
+    input.arguments.push_back("-s" + std::string(size / 2, '='));
+}
+
+// Many short tokens, all for the same argument.
+void make_many_tokens(Input& input, size_t size) {
+    input.parser->add_int_argument('n', "number").mark_multi_value();
+    input.option_count = 1;
+
+    for (size_t i = 0; i < size / 8; i++) {
+        input.arguments.push_back("-n=" + std::to_string(i % 1000));
+        input.arguments.push_back("--number=1");
+    }
+}
+
+// As many arguments as tokens, each given once: 100k arguments at the largest size.
+void make_many_options(Input& input, size_t size) {
+    input.option_count = size / 10;
+    for (size_t i = 0; i < input.option_count; i++) {
+        const char* name = input.add_name("option" + std::to_string(i));
+        input.parser->add_int_argument(name).set_default_value(0);
+        input.arguments.push_back("--" + std::string(name) + "=1");
+    }
+}
+
+// Many delimited tokens for the same argument, every one split into two values.
+void make_delimited_values(Input& input, size_t size) {
+    input.parser->add_int_argument("ids").mark_multi_value(0, 0, ',');
+    input.option_count = 1;
+
+    for (size_t i = 0; i < size / 12; i++) {
+        input.arguments.push_back("--ids=7," + std::to_string(i % 1000));
+    }
+}
+
+// Positional tokens split by flags into many runs, over positionals with bounded and unbounded counts.
+void make_positional_runs(Input& input, size_t size) {
+    input.parser->add_flag('f', "flag").mark_multi_value();
+    input.parser->add_int_argument("Mode").mask_positional(1, 1);
+    input.parser->add_int_argument("Extra").mask_positional(0, 3);
+    input.parser->add_int_argument("Values").mask_positional(1);
+    input.parser->add_int_argument("Dst").mask_positional(1, 1);
+    input.option_count = 5;
+
+    for (size_t i = 0; i < size / 8; i++) {
+        input.arguments.push_back(std::to_string(i % 1000));
+        input.arguments.push_back("-f");
+    }
+}
+
+// As many arguments as tokens, each given by an abbreviation of its name.
+void make_abbreviations(Input& input, size_t size) {
+    input.parser->set_allow_abbreviations(true);
+    input.option_count = size / 20;
+    for (size_t i = 0; i < input.option_count; i++) {
+        std::string prefix = "option" + std::to_string(i) + "-";
+        input.parser->add_int_argument(input.add_name(prefix + "value")).set_default_value(0);
+        input.arguments.push_back("--" + prefix + "=1");
+    }
+}
+
+// Every run parses with a new parser, so that storage grown by an earlier run cannot hide a path
+// that reallocates on every token. Building the input is not timed. Runs until SECONDS_PER_SIZE is
+// spent, at least MIN_RUNS times, and reports the fastest run.
+Bench::Result measure_parse(const Scenario& make_input, size_t size) {
+    Bench::Result result;
+    double total_nanoseconds = 0;
+    // Shared by the runs, so that a huge error message does not grow a new buffer every time.
+    std::ostringstream errors;
+
+    for (size_t run = 0; run < MIN_RUNS || total_nanoseconds < SECONDS_PER_SIZE * 1e9; run++) {
+        Input input;
+        make_input(input, size);
+        input.parser->set_error_stream(&errors);
+        errors.str("");
+
+        size_t allocations_before = Bench::allocation_count();
+        auto start = std::chrono::steady_clock::now();
+        input.parser->parse(input.arguments);
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        total_nanoseconds += nanoseconds;
+        if (run == 0 || nanoseconds < result.nanoseconds_per_run) {
+            result.nanoseconds_per_run = nanoseconds;
+            result.allocations_per_run = static_cast<double>(Bench::allocation_count() - allocations_before);
+        }
+
+        if (nanoseconds > MAX_SECONDS_PER_RUN * 1e9) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+// Least squares slope of log(nanoseconds) over log(work).
+double fit_slope(const std::vector<double>& works, const std::vector<double>& nanoseconds) {
+    double mean_x = 0;
+    double mean_y = 0;
+    for (size_t i = 0; i < works.size(); i++) {
+        mean_x += std::log(works[i]) / works.size();
+        mean_y += std::log(nanoseconds[i]) / works.size();
+    }
+
+    double covariance = 0;
+    double variance = 0;
+    for (size_t i = 0; i < works.size(); i++) {
+        double dx = std::log(works[i]) - mean_x;
+        covariance += dx * (std::log(nanoseconds[i]) - mean_y);
+        variance += dx * dx;
+    }
+
+    return covariance / variance;
+}
+
+bool check_scenario(const char* name, const Scenario& make_input) {
+    const size_t sizes[] = {1 << 14, 1 << 16, 1 << 18, 1 << 20};
+
+    std::vector<double> works;
+    std::vector<double> nanoseconds;
+    for (size_t size : sizes) {
+        Input input;
+        make_input(input, size);
+        size_t work = input.get_work();
+
+        Bench::Result result = measure_parse(make_input, size);
+        Bench::report(name, work, result);
+        works.push_back(static_cast<double>(work));
+        nanoseconds.push_back(std::max(result.nanoseconds_per_run, 1.0));
+
+        if (result.nanoseconds_per_run > MAX_SECONDS_PER_RUN * 1e9) {
+            std::printf("%-40s FAILED: one parse took over %.0f s\n", name, MAX_SECONDS_PER_RUN);
+            return false;
+        }
+    }
+
+    double slope = fit_slope(works, nanoseconds);
+    if (slope > MAX_SLOPE) {
+        std::printf("%-40s FAILED: time grows as work^%.2f\n", name, slope);
+        return false;
+    }
+
+    std::printf("%-40s time grows as work^%.2f\n", name, slope);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    bool is_linear = true;
+    is_linear &= check_scenario("short cluster", make_short_cluster);
+    is_linear &= check_scenario("huge value", make_huge_value);
+    is_linear &= check_scenario("huge unknown name", make_huge_name);
+    is_linear &= check_scenario("equals signs", make_equals_signs);
+    is_linear &= check_scenario("many tokens", make_many_tokens);
+    is_linear &= check_scenario("many options", make_many_options);
+    is_linear &= check_scenario("delimited values", make_delimited_values);
+    is_linear &= check_scenario("positional runs", make_positional_runs);
+    is_linear &= check_scenario("abbreviations", make_abbreviations);
+
+    return is_linear ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+// A typical command line: a few options, some of them with separate values, and positionals.
+std::vector<std::string> make_command_line(size_t positional_count) {
+    std::vector<std::string> arguments = {"app", "-v", "--output", "result.txt", "--level=3", "-j", "8"};
+    for (size_t i = 0; i < positional_count; i++) {
+        arguments.push_back(std::to_string(i));
+    }
+
+    arguments.push_back("--name=bench");
+    return arguments;
+}
+
+void bench_command_line(size_t positional_count) {
+    std::vector<std::string> arguments = make_command_line(positional_count);
+
+    std::vector<const char*> argv;
+    for (const std::string& argument : arguments) {
+        argv.push_back(argument.c_str());
+    }
+
+    std::vector<int> values;
+    ArgParser parser("Bench");
+    parser.add_flag('v', "verbose");
+    parser.add_string_argument('o', "output");
+    parser.add_int_argument("level");
+    parser.add_int_argument('j', "jobs");
+    parser.add_string_argument("name");
+    parser.add_int_argument("N").mark_multi_value(1).mask_positional().store_values(values);
+
+    parser.parse(argv.size(), argv.data());
+
+    // parse appends to the stored vector.
+    Bench::Result result = Bench::measure(100000, [&] {
+        values.clear();
+        parser.parse(argv.size(), argv.data());
+    });
+    Bench::report("parse(argc, argv)", argv.size(), result);
+
+    result = Bench::measure(100000, [&] {
+        values.clear();
+        parser.parse(arguments);
+    });
+    Bench::report("parse(std::vector<std::string>)", argv.size(), result);
+}
+
+} // namespace
+
+int main() {
+    for (size_t positional_count : {1, 8, 32, 128}) {
+        bench_command_line(positional_count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <argparser.h>
+#include <batch_parser.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+constexpr size_t LINE_COUNT = 200000;
+
+std::unique_ptr<ArgParser> create_parser() {
+    auto parser = std::make_unique<ArgParser>("Job");
+    parser->add_flag('v', "verbose");
+    parser->add_string_argument('o', "output").set_default_value("");
+    parser->add_int_argument("level").set_default_value(0);
+    parser->add_int_argument('j', "jobs").set_default_value(1);
+    parser->add_int_argument("N").mark_multi_value().mask_positional();
+    return parser;
+}
+
+} // namespace
+
+int main() {
+    std::string input;
+    for (size_t i = 0; i < LINE_COUNT; i++) {
+        input += "job -v --output result" + std::to_string(i) + ".txt --level=" + std::to_string(i % 10) + " -j 8 1 2 3 4\n";
+    }
+
+    size_t max_thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+
+    std::string output;
+    for (size_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        BatchParser batch_parser(create_parser);
+        batch_parser.set_thread_count(thread_count);
+
+        Bench::Result result = Bench::measure(1, [&] {
+            batch_parser.parse_lines(input, output);
+        });
+
+        std::printf("threads=%-3zu %14.0f lines/s\n", thread_count, LINE_COUNT / (result.nanoseconds_per_run * 1e-9));
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+
+namespace Bench {
+
+struct Result {
+    double nanoseconds_per_run = 0;
+    double allocations_per_run = 0;
+};
+
+// Runs body `runs` times and reports the mean wall time and allocation count.
+template <typename Body> Result measure(size_t runs, Body&& body) {
+    size_t allocations_before = allocation_count();
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < runs; i++) {
+        body();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t allocations = allocation_count() - allocations_before;
+
+    Result result;
+    result.nanoseconds_per_run = std::chrono::duration<double, std::nano>(elapsed).count() / runs;
+    result.allocations_per_run = static_cast<double>(allocations) / runs;
+    return result;
+}
+
+inline void report(const char* name, size_t size, const Result& result) {
+    std::printf("%-40s n=%-9zu %14.1f ns/run %12.1f allocs/run\n", name, size, result.nanoseconds_per_run, result.allocations_per_run);
+}
+
+// Builds "app <prefix>0 <prefix>1 ..." as an argv-like vector of strings.
+inline std::vector<std::string> make_arguments(size_t count, const std::string& prefix = "") {
+    std::vector<std::string> arguments;
+    arguments.reserve(count + 1);
+    arguments.emplace_back("app");
+
+    for (size_t i = 0; i < count; i++) {
+        arguments.push_back(prefix + std::to_string(i % 1000));
+    }
+
+    return arguments;
+}
+
+} // namespace Bench
@@ -0,0 +1,81 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+constexpr size_t OPTION_COUNT = 900;
+
+enum class Level {
+    Low,
+    Medium,
+    High,
+};
+
+constexpr auto LEVELS = make_choice_table<Level>({
+    {"low", Level::Low},
+    {"medium", Level::Medium},
+    {"high", Level::High},
+});
+
+void add_options(ArgParser& parser, const std::vector<std::string>& names) {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (i % 9 == 0) {
+            parser.add_choice_argument<LEVELS>(names[i].c_str());
+        } else if (i % 3 == 0) {
+            parser.add_flag(names[i].c_str());
+        } else {
+            parser.add_int_argument(names[i].c_str()).set_default_value(0);
+        }
+    }
+}
+
+void bench_query(ArgParser& parser, const std::vector<std::string>& arguments, size_t cursor_index, const char* label) {
+    size_t candidate_count = 0;
+    Bench::Result result = Bench::measure(1000, [&] {
+        CompletionResult completion = parser.complete(arguments, cursor_index);
+        candidate_count = completion.options.size() + completion.values.size();
+    });
+    Bench::report(label, candidate_count, result);
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        names.push_back("option-" + std::to_string(i * 7919 % 100000) + "-name");
+    }
+
+    // 30 options already typed, then the token being completed.
+    std::vector<std::string> arguments = {"app"};
+    for (size_t i = 0; i < 30; i++) {
+        arguments.push_back("--" + names[i * 31 % OPTION_COUNT] + "=1");
+    }
+
+    ArgParser parser("Bench");
+    add_options(parser, names);
+
+    arguments.push_back("--");
+    bench_query(parser, arguments, arguments.size() - 1, "900 options, all long names");
+
+    arguments.back() = "--option-1";
+    bench_query(parser, arguments, arguments.size() - 1, "900 options, name prefix");
+
+    arguments.back() = "--" + names[0] + "=m";
+    bench_query(parser, arguments, arguments.size() - 1, "900 options, choice value");
+
+    // What a shell pays per key press: the schema is built and frozen by a fresh process.
+    arguments.back() = "--option-1";
+    size_t candidate_count = 0;
+    Bench::Result result = Bench::measure(100, [&] {
+        ArgParser fresh_parser("Bench");
+        add_options(fresh_parser, names);
+        candidate_count = fresh_parser.complete(arguments, arguments.size() - 1).options.size();
+    });
+    Bench::report("900 options, new parser + name prefix", candidate_count, result);
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <argparser.h>
+#include <config_watcher.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+constexpr size_t OPTION_COUNT = 10000;
+
+std::unique_ptr<ArgParser> create_parser(const std::vector<std::string>& names) {
+    auto parser = std::make_unique<ArgParser>("Daemon");
+    for (const std::string& name : names) {
+        parser->add_string_argument(name.c_str()).set_default_value("");
+    }
+
+    return parser;
+}
+
+void write_config(const std::string& path, const std::vector<std::string>& names, size_t edit) {
+    std::ofstream output(path);
+    for (size_t i = 0; i < names.size(); i++) {
+        output << names[i] << "=value-" << (i == 0 ? edit : i) << '\n';
+    }
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        names.push_back("option-" + std::to_string(i));
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "argparser_config_reload_bench.conf").string();
+    write_config(path, names, 0);
+
+    // reload is called directly; the file is rewritten with one changed line before every call.
+    // Nothing holds the results, so every reload parses into the parser replaced by the one before.
+    ConfigWatcher watcher([&names] {
+        return create_parser(names);
+    }, {"daemon"}, path);
+    watcher.reload();
+
+    size_t edit = 0;
+    Bench::Result result = Bench::measure(20, [&] {
+        write_config(path, names, ++edit);
+        watcher.reload();
+    });
+    Bench::report("10k-line config, one line changed", OPTION_COUNT, result);
+
+    result = Bench::measure(20, [&] {
+        write_config(path, names, ++edit);
+    });
+    Bench::report("10k-line config, writing the file only", OPTION_COUNT, result);
+
+    std::vector<std::string> tokens = {"daemon"};
+    for (size_t i = 0; i < names.size(); i++) {
+        tokens.push_back("--" + names[i] + "=value-" + std::to_string(i));
+    }
+
+    result = Bench::measure(20, [&] {
+        create_parser(names)->parse(tokens);
+    });
+    Bench::report("10k options, new parser + full parse", OPTION_COUNT, result);
+
+    std::unique_ptr<ArgParser> previous = create_parser(names);
+    previous->parse(tokens);
+
+    std::vector<std::string_view> changed_tokens = {"daemon", "--option-0=changed"};
+    std::vector<std::string_view> reparsed_names = {"option-0"};
+    std::vector<const char*> changed_names;
+
+    result = Bench::measure(20, [&] {
+        create_parser(names)->freeze();
+    });
+    Bench::report("10k options, new parser only", OPTION_COUNT, result);
+
+    std::unique_ptr<ArgParser> current = create_parser(names);
+    current->parse(tokens);
+
+    result = Bench::measure(20, [&] {
+        current->parse_incremental(changed_tokens, *previous, reparsed_names, changed_names);
+    });
+    Bench::report("10k options, one option re-parsed into a built parser", OPTION_COUNT, result);
+
+    std::filesystem::remove(path);
+    return 0;
+}
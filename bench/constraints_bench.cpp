@@ -0,0 +1,60 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+constexpr size_t OPTION_COUNT = 4096;
+constexpr size_t RULE_COUNT = 300;
+
+void bench_constraints(size_t rule_count, const std::vector<std::string>& names, const std::vector<std::string_view>& arguments) {
+    ArgParser parser("Bench");
+
+    for (const std::string& name : names) {
+        parser.add_flag(name.c_str());
+    }
+
+    for (size_t i = 0; i < rule_count; i++) {
+        const char* first = names[i * 13 % OPTION_COUNT].c_str();
+        const char* second = names[(i * 13 + 1) % OPTION_COUNT].c_str();
+        const char* third = names[(i * 13 + 2) % OPTION_COUNT].c_str();
+
+        switch (i % 3) {
+            case 0:
+                parser.add_mutually_exclusive_group({first, second, third});
+                break;
+            case 1:
+                parser.add_requirement(first, {second, third});
+                break;
+            case 2:
+                parser.add_at_least_one_of_group({first, second, third, names[0].c_str()});
+                break;
+        }
+    }
+
+    parser.parse(arguments);
+
+    Bench::Result result = Bench::measure(1000, [&] {
+        parser.parse(arguments);
+    });
+    Bench::report(rule_count == 0 ? "4k flags, no rules" : "4k flags, 300 rules", arguments.size() - 1, result);
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        names.push_back("flag" + std::to_string(i));
+    }
+
+    std::vector<std::string> arguments = {"app", "--flag0", "--flag4000"};
+    std::vector<std::string_view> argument_views(arguments.begin(), arguments.end());
+
+    bench_constraints(0, names, argument_views);
+    bench_constraints(RULE_COUNT, names, argument_views);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <argparser.h>
+
+#include <charconv>
+#include <random>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+// The usual hand-written alternative: find each delimiter and convert the piece with from_chars.
+bool split_scalar(std::string_view token, std::vector<int>& values) {
+    size_t begin = 0;
+    while (true) {
+        size_t end = token.find(',', begin);
+        if (end == std::string_view::npos) {
+            end = token.size();
+        }
+
+        int value = 0;
+        auto [pointer, error_code] = std::from_chars(token.data() + begin, token.data() + end, value);
+        if (error_code != std::errc() || pointer != token.data() + end) {
+            return false;
+        }
+
+        values.push_back(value);
+        if (end == token.size()) {
+            return true;
+        }
+
+        begin = end + 1;
+    }
+}
+
+void bench_list(size_t value_count, size_t max_value) {
+    std::mt19937 random(42);
+    std::string token = "--ids=";
+    for (size_t i = 0; i < value_count; i++) {
+        if (i != 0) {
+            token += ',';
+        }
+
+        token += std::to_string(random() % max_value);
+    }
+
+    std::vector<std::string> arguments = {"app", token};
+    std::string_view list = std::string_view(token).substr(6);
+
+    std::vector<int> values;
+    ArgParser parser("Bench");
+    parser.add_int_argument("ids").mark_multi_value(0, 0, ',').store_values(values);
+    parser.parse(arguments);
+
+    size_t runs = 20000000 / token.size() + 1;
+    // parse appends to the stored vector.
+    Bench::Result result = Bench::measure(runs, [&] {
+        values.clear();
+        parser.parse(arguments);
+    });
+    Bench::report("delimited multi-value", value_count, result);
+
+    std::vector<int> scalar_values;
+    result = Bench::measure(runs, [&] {
+        scalar_values.clear();
+        split_scalar(list, scalar_values);
+    });
+    Bench::report("scalar split + from_chars", value_count, result);
+}
+
+} // namespace
+
+int main() {
+    for (size_t value_count : {100, 10000, 100000}) {
+        bench_list(value_count, 1000);
+        bench_list(value_count, 1000000000);
+    }
+
+    return 0;
+}
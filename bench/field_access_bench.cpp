@@ -0,0 +1,77 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+struct Options {
+    std::string output;
+    int level = 0;
+    int jobs = 1;
+    bool verbose = false;
+};
+
+// Keeps the compiler from dropping reads whose result is otherwise unused.
+template <typename T> void keep(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> arguments = {"app", "-v", "--output=result.txt", "--level=3", "--jobs=8"};
+
+    Options options;
+    ArgParser bound_parser("Bench");
+    bound_parser.bind_fields(options,
+        field(&Options::output, "output"),
+        field(&Options::level, "level"),
+        field(&Options::jobs, "jobs"),
+        field(&Options::verbose, 'v', "verbose"));
+    bound_parser.parse(arguments);
+
+    ArgParser parser("Bench");
+    ArgumentHandle<std::string> output = parser.add_string_argument("output").handle();
+    ArgumentHandle<int> level = parser.add_int_argument("level").handle();
+    ArgumentHandle<int> jobs = parser.add_int_argument("jobs").handle();
+    ArgumentHandle<bool> verbose = parser.add_flag('v', "verbose").handle();
+    parser.parse(arguments);
+
+    Bench::Result result = Bench::measure(1000000, [&] {
+        keep(options.output);
+        keep(options.level);
+        keep(options.jobs);
+        keep(options.verbose);
+    });
+    Bench::report("struct fields", 4, result);
+
+    result = Bench::measure(1000000, [&] {
+        keep(parser[output]);
+        keep(parser[level]);
+        keep(parser[jobs]);
+        keep(parser[verbose]);
+    });
+    Bench::report("argument handles", 4, result);
+
+    result = Bench::measure(1000000, [&] {
+        keep(parser.get_string_value("output"));
+        keep(parser.get_int_value("level"));
+        keep(parser.get_int_value("jobs"));
+        keep(parser.get_flag("verbose"));
+    });
+    Bench::report("get_*_value", 4, result);
+
+    result = Bench::measure(100000, [&] {
+        bound_parser.parse(arguments);
+    });
+    Bench::report("parse into struct", arguments.size() - 1, result);
+
+    result = Bench::measure(100000, [&] {
+        parser.parse(arguments);
+    });
+    Bench::report("parse into arguments", arguments.size() - 1, result);
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+void bench_eager(const std::vector<std::string>& arguments) {
+    std::vector<std::string_view> argument_views(arguments.begin(), arguments.end());
+    long long sum = 0;
+
+    Bench::Result result = Bench::measure(3, [&] {
+        ArgParser parser("Bench");
+        IntArgument& argument = parser.add_int_argument("N").mark_multi_value(1).mask_positional();
+        parser.parse(argument_views);
+
+        for (size_t i = 0; i < argument.get_value_count(); i++) {
+            sum += std::any_cast<int>(argument.get_value(i));
+        }
+    });
+    Bench::report("eager parse + iterate", arguments.size() - 1, result);
+}
+
+void bench_lazy(const std::vector<std::string>& arguments) {
+    std::vector<std::string_view> argument_views(arguments.begin(), arguments.end());
+    long long sum = 0;
+
+    Bench::Result result = Bench::measure(3, [&] {
+        ArgParser parser("Bench");
+        IntArgument& argument = parser.add_int_argument("N").mark_multi_value(1).mask_positional();
+        parser.parse_lazy(argument_views);
+
+        for (std::optional<int> value : parser.lazy_values(argument)) {
+            sum += *value;
+        }
+    });
+    Bench::report("lazy parse + pull", arguments.size() - 1, result);
+
+    result = Bench::measure(3, [&] {
+        ArgParser parser("Bench");
+        IntArgument& argument = parser.add_int_argument("N").mark_multi_value(1).mask_positional();
+        parser.parse_lazy(argument_views);
+
+        for (std::optional<int> value : parser.lazy_values(argument)) {
+            sum += *value;
+            break;
+        }
+    });
+    Bench::report("lazy parse + first value", arguments.size() - 1, result);
+}
+
+} // namespace
+
+int main() {
+    for (size_t value_count : {1000, 1000000}) {
+        std::vector<std::string> arguments = Bench::make_arguments(value_count);
+        bench_eager(arguments);
+        bench_lazy(arguments);
+    }
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+size_t runs_for(size_t value_count) {
+    return std::max<size_t>(3, 1000000 / value_count);
+}
+
+void bench_positional(size_t value_count) {
+    std::vector<std::string> arguments = Bench::make_arguments(value_count);
+
+    Bench::Result result = Bench::measure(runs_for(value_count), [&] {
+        ArgParser parser("Bench");
+        parser.add_int_argument("N").mark_multi_value(1).mask_positional();
+        parser.parse(arguments);
+    });
+    Bench::report("positional, inline storage", value_count, result);
+
+    result = Bench::measure(runs_for(value_count), [&] {
+        std::vector<int> values;
+        ArgParser parser("Bench");
+        parser.add_int_argument("N").mark_multi_value(1).mask_positional().store_values(values);
+        parser.parse(arguments);
+    });
+    Bench::report("positional, store_values", value_count, result);
+}
+
+void bench_named(size_t value_count) {
+    std::vector<std::string> arguments = Bench::make_arguments(value_count, "--value=");
+
+    Bench::Result result = Bench::measure(runs_for(value_count), [&] {
+        ArgParser parser("Bench");
+        parser.add_int_argument("value").mark_multi_value();
+        parser.parse(arguments);
+    });
+    Bench::report("named, no hint", value_count, result);
+
+    result = Bench::measure(runs_for(value_count), [&] {
+        ArgParser parser("Bench");
+        parser.add_int_argument("value").mark_multi_value(0, value_count);
+        parser.parse(arguments);
+    });
+    Bench::report("named, capacity hint", value_count, result);
+}
+
+} // namespace
+
+int main() {
+    for (size_t value_count : {1, 8, 1000, 1000000}) {
+        bench_positional(value_count);
+        bench_named(value_count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+constexpr size_t OPTION_COUNT = 50;
+
+void build_parser(ArgParser& parser, std::vector<std::string>& names) {
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        names.push_back("option" + std::to_string(i));
+    }
+
+    for (size_t i = 0; i < OPTION_COUNT; i++) {
+        if (i % 2 == 0) {
+            parser.add_string_argument(names[i].c_str()).set_default_value("");
+        } else {
+            parser.add_int_argument(names[i].c_str()).set_default_value(0);
+        }
+    }
+
+    parser.add_int_argument("N").mark_multi_value().mask_positional();
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> arguments = {"app"};
+    for (size_t i = 0; i < 20; i++) {
+        arguments.push_back("--option" + std::to_string(i) + "=" + std::to_string(i));
+    }
+
+    for (size_t i = 0; i < 10; i++) {
+        arguments.push_back(std::to_string(i));
+    }
+
+    std::vector<std::string_view> argument_views(arguments.begin(), arguments.end());
+
+    std::vector<std::string> names;
+    ArgParser parser("Bench");
+    build_parser(parser, names);
+
+    Bench::Result result = Bench::measure(100000, [&] {
+        parser.parse(argument_views);
+    });
+    Bench::report("full parse", argument_views.size() - 1, result);
+
+    std::vector<std::string> cached_names;
+    ArgParser cached_parser("Bench");
+    build_parser(cached_parser, cached_names);
+    cached_parser.enable_parse_cache(1024);
+    cached_parser.parse(argument_views);
+
+    result = Bench::measure(100000, [&] {
+        cached_parser.parse(argument_views);
+    });
+    Bench::report("cache hit", argument_views.size() - 1, result);
+
+    ParseCacheStats stats = cached_parser.get_parse_cache_stats();
+    std::printf("    hits: %zu, misses: %zu\n", stats.hits, stats.misses);
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+size_t runs_for(size_t value_count) {
+    return std::max<size_t>(3, 1000000 / value_count);
+}
+
+void add_positionals(ArgParser& parser, bool is_split) {
+    if (!is_split) {
+        parser.add_int_argument("Values").mask_positional(1);
+        return;
+    }
+
+    // MODE [EXTRA{0,3}] VALUES... DST
+    parser.add_int_argument("Mode").mask_positional(1, 1);
+    parser.add_int_argument("Extra").mask_positional(0, 3);
+    parser.add_int_argument("Values").mask_positional(1);
+    parser.add_int_argument("Dst").mask_positional(1, 1);
+}
+
+void bench_positionals(size_t token_count, bool is_split, const char* label, const char* lazy_label) {
+    std::vector<std::string> arguments = Bench::make_arguments(token_count);
+    std::vector<std::string_view> argument_views(arguments.begin(), arguments.end());
+
+    // The parser is reused, so the layout is computed once and every parse only splits the tokens.
+    ArgParser parser("Bench");
+    add_positionals(parser, is_split);
+
+    Bench::Result result = Bench::measure(runs_for(token_count), [&] {
+        parser.parse(argument_views);
+    });
+    Bench::report(label, token_count, result);
+
+    // Values is left unconverted, so this is the cost of scanning and splitting the tokens.
+    result = Bench::measure(runs_for(token_count), [&] {
+        parser.parse_lazy(argument_views);
+    });
+    Bench::report(lazy_label, token_count, result);
+}
+
+} // namespace
+
+int main() {
+    for (size_t token_count : {1000, 1000000}) {
+        bench_positionals(token_count, false, "one variadic positional", "one variadic positional, lazy");
+        bench_positionals(token_count, true, "mode, extra{0,3}, values..., dst", "mode, extra{0,3}, values..., dst, lazy");
+    }
+
+    return 0;
+}
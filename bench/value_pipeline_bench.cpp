@@ -0,0 +1,84 @@
+#include <argparser.h>
+
+#include "bench_utils.h"
+
+using namespace ArgumentParser;
+
+namespace {
+
+struct CountedValue {
+    static inline size_t copies = 0;
+
+    std::string text;
+
+    explicit CountedValue(const char* text) : text(text) {}
+
+    CountedValue(const CountedValue& other) : text(other.text) {
+        copies++;
+    }
+
+    CountedValue(CountedValue&&) = default;
+
+    CountedValue& operator=(const CountedValue& other) {
+        this->text = other.text;
+        copies++;
+        return *this;
+    }
+
+    CountedValue& operator=(CountedValue&&) = default;
+};
+
+constexpr auto parse_counted = [](const char* string_value, const std::optional<CountedValue>&) -> std::optional<CountedValue> {
+    return CountedValue(string_value);
+};
+
+typedef Argument<CountedValue, parse_counted> CountedArgument;
+
+// Long enough to defeat the small string optimization, so every string copy allocates.
+const std::string LONG_VALUE = "a-value-that-does-not-fit-into-sso-storage-";
+
+void bench_string_values(size_t value_count) {
+    std::vector<std::string> arguments = Bench::make_arguments(value_count, "--value=" + LONG_VALUE);
+    size_t runs = std::max<size_t>(3, 100000 / value_count);
+
+    // Parser setup allocations are measured separately and subtracted.
+    Bench::Result setup = Bench::measure(runs, [&] {
+        ArgParser parser("Bench");
+        parser.add_string_argument("value").mark_multi_value(0, value_count);
+        parser.parse(std::vector<std::string>{"app"});
+    });
+
+    Bench::Result result = Bench::measure(runs, [&] {
+        ArgParser parser("Bench");
+        parser.add_string_argument("value").mark_multi_value(0, value_count);
+        parser.parse(arguments);
+    });
+    Bench::report("string values", value_count, result);
+
+    std::printf("    string allocations per value: %.2f\n", (result.allocations_per_run - setup.allocations_per_run) / value_count);
+}
+
+void bench_counted_values(size_t value_count) {
+    std::vector<std::string> arguments = Bench::make_arguments(value_count, "--value=");
+
+    CountedValue::copies = 0;
+    Bench::Result result = Bench::measure(1, [&] {
+        ArgParser parser("Bench");
+        parser.add_argument<CountedArgument>("value", nullptr).mark_multi_value();
+        parser.parse(arguments);
+    });
+    Bench::report("counted values (lambda converter)", value_count, result);
+
+    std::printf("    copies per value: %.2f\n", static_cast<double>(CountedValue::copies) / value_count);
+}
+
+} // namespace
+
+int main() {
+    for (size_t value_count : {1, 8, 1000, 100000}) {
+        bench_string_values(value_count);
+        bench_counted_values(value_count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <argparser.h>
+#include <batch_parser.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "job_schema.h"
+
+// Validates and normalizes a file of command lines against a schema given on the command line:
+//   argparser_batch --input=jobs.txt --output=results.txt --int=level --flag=verbose --positional=files
+// Every valid line is written back with all options spelled out, defaults included.
+int main(int argc, const char** argv) {
+    std::string input;
+    std::string output;
+    int thread_count = 0;
+    JobSchema schema;
+
+    ArgumentParser::ArgParser parser("argparser_batch");
+    parser.add_string_argument('i', "input", "File with one command line per line").store_value(input);
+    parser.add_string_argument('o', "output", "File for the per-line results").store_value(output);
+    parser.add_int_argument('j', "threads", "Worker threads, 0 for one per hardware thread").set_default_value(0).store_value(thread_count);
+    add_schema_arguments(parser, schema);
+    parser.add_help('h', "help", "Parse a file of command lines in parallel");
+
+    if (!parser.parse(argc, argv) || schema.positional.size() > 1) {
+        std::cout << parser.get_help_description() << std::endl;
+        return 1;
+    }
+
+    if (parser.help()) {
+        std::cout << parser.get_help_description() << std::endl;
+        return 0;
+    }
+
+    auto create_parser = [&schema] {
+        return create_job_parser(schema);
+    };
+
+    auto format_result = [&schema](ArgumentParser::ArgParser& job_parser, std::string& result) {
+        result += "job";
+
+        for (const std::string& name : schema.string_options) {
+            result += " --" + name + "=" + job_parser.get_string_value(name.c_str());
+        }
+
+        for (const std::string& name : schema.int_options) {
+            result += " --" + name + "=" + std::to_string(job_parser.get_int_value(name.c_str()));
+        }
+
+        for (const std::string& name : schema.flags) {
+            if (job_parser.get_flag(name.c_str())) {
+                result += " --" + name;
+            }
+        }
+
+        for (const std::string& name : schema.positional) {
+            auto& argument = job_parser.get_argument<ArgumentParser::StringArgument>(name.c_str());
+            for (size_t i = 0; i < argument.get_value_count(); i++) {
+                result += " " + job_parser.get_string_value(name.c_str(), i);
+            }
+        }
+    };
+
+    ArgumentParser::BatchParser batch_parser(create_parser, format_result);
+    batch_parser.set_thread_count(thread_count);
+
+    if (!batch_parser.parse_file(input.c_str(), output.c_str())) {
+        return 1;
+    }
+
+    ArgumentParser::BatchStats stats = batch_parser.get_stats();
+    std::cout << "Lines: " << stats.line_count << ", errors: " << stats.error_count << std::endl;
+
+    return 0;
+}
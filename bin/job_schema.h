@@ -0,0 +1,45 @@
+#pragma once
+
+#include <argparser.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Schema of the command lines handled by the batch and replay tools, given on their own command line:
+//   --string=output --int=level --flag=verbose --positional=files
+struct JobSchema {
+    std::vector<std::string> string_options;
+    std::vector<std::string> int_options;
+    std::vector<std::string> flags;
+    std::vector<std::string> positional;
+};
+
+inline void add_schema_arguments(ArgumentParser::ArgParser& parser, JobSchema& schema) {
+    parser.add_string_argument("string", "Name of a string option").mark_multi_value().store_values(schema.string_options);
+    parser.add_string_argument("int", "Name of an int option").mark_multi_value().store_values(schema.int_options);
+    parser.add_string_argument("flag", "Name of a flag").mark_multi_value().store_values(schema.flags);
+    parser.add_string_argument("positional", "Name of the positional arguments").mark_multi_value(0, 1).store_values(schema.positional);
+}
+
+// Options are optional with empty and zero defaults. The names are owned by schema.
+inline std::unique_ptr<ArgumentParser::ArgParser> create_job_parser(const JobSchema& schema) {
+    auto job_parser = std::make_unique<ArgumentParser::ArgParser>("job");
+    for (const std::string& name : schema.string_options) {
+        job_parser->add_string_argument(name.c_str()).set_default_value("");
+    }
+
+    for (const std::string& name : schema.int_options) {
+        job_parser->add_int_argument(name.c_str()).set_default_value(0);
+    }
+
+    for (const std::string& name : schema.flags) {
+        job_parser->add_flag(name.c_str());
+    }
+
+    for (const std::string& name : schema.positional) {
+        job_parser->add_string_argument(name.c_str()).mark_multi_value().mask_positional();
+    }
+
+    return job_parser;
+}
@@ -5,18 +5,19 @@
 #include <numeric>
 
 struct Options {
+    std::vector<int> values;
     bool sum = false;
     bool mult = false;
 };
 
 int main(int argc, const char** argv) {
     Options opt;
-    std::vector<int> values;
 
     ArgumentParser::ArgParser parser("Program");
-    parser.add_int_argument("N").mark_multi_value(1).mask_positional().store_values(values);
-    parser.add_flag("sum", "add args").store_value(opt.sum);
-    parser.add_flag("mult", "multiply args").store_value(opt.mult);
+    parser.bind_field(opt, ArgumentParser::field(&Options::values, "N")).mark_multi_value(1).mask_positional();
+    parser.bind_fields(opt,
+        ArgumentParser::field(&Options::sum, "sum", "add args"),
+        ArgumentParser::field(&Options::mult, "mult", "multiply args"));
     parser.add_help('h', "help", "Program accumulate arguments");
 
     if(!parser.parse(argc, argv)) {
@@ -31,9 +32,9 @@ int main(int argc, const char** argv) {
     }
 
     if(opt.sum) {
-        std::cout << "Result: " << std::accumulate(values.begin(), values.end(), 0) << std::endl;
+        std::cout << "Result: " << std::accumulate(opt.values.begin(), opt.values.end(), 0) << std::endl;
     } else if(opt.mult) {
-        std::cout << "Result: " << std::accumulate(values.begin(), values.end(), 1, std::multiplies<int>()) << std::endl;
+        std::cout << "Result: " << std::accumulate(opt.values.begin(), opt.values.end(), 1, std::multiplies<int>()) << std::endl;
     } else {
         std::cout << "No one options had chosen" << std::endl;
         std::cout << parser.get_help_description();
@@ -0,0 +1,102 @@
+#include <argparser.h>
+#include <capture_log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "job_schema.h"
+
+// Replays command lines recorded with ARGPARSER_CAPTURE against a schema given on the command line:
+//   argparser_replay --log=capture.bin --int=level --flag=verbose --positional=files
+// and reports parse latency percentiles and allocations, next to the latencies seen when capturing.
+namespace {
+
+double percentile(const std::vector<double>& sorted_values, double fraction) {
+    if (sorted_values.empty()) {
+        return 0;
+    }
+
+    size_t index = std::min(sorted_values.size() - 1, static_cast<size_t>(fraction * sorted_values.size()));
+    return sorted_values[index];
+}
+
+void report(const char* name, std::vector<double>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%-10s p50 %10.0f ns   p90 %10.0f ns   p99 %10.0f ns   max %10.0f ns\n", name,
+        percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99), latencies.empty() ? 0 : latencies.back());
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+    // The replay itself must not be captured.
+    unsetenv(ArgumentParser::CAPTURE_LOG_VARIABLE);
+
+    std::string log_path;
+    int repeat_count = 1;
+    JobSchema schema;
+
+    ArgumentParser::ArgParser parser("argparser_replay");
+    parser.add_string_argument('l', "log", "Capture log written with ARGPARSER_CAPTURE").store_value(log_path);
+    parser.add_int_argument('r', "repeat", "Number of times every command line is parsed").set_default_value(1).store_value(repeat_count);
+    add_schema_arguments(parser, schema);
+    parser.add_help('h', "help", "Replay captured command lines and report parse latency");
+
+    if (!parser.parse(argc, argv) || schema.positional.size() > 1 || repeat_count < 1) {
+        std::cout << parser.get_help_description() << std::endl;
+        return 1;
+    }
+
+    if (parser.help()) {
+        std::cout << parser.get_help_description() << std::endl;
+        return 0;
+    }
+
+    std::vector<ArgumentParser::CapturedCommandLine> command_lines;
+    if (!ArgumentParser::CaptureLog::read(log_path.c_str(), command_lines)) {
+        return 1;
+    }
+
+    std::unique_ptr<ArgumentParser::ArgParser> job_parser = create_job_parser(schema);
+    std::ostringstream errors;
+    job_parser->set_error_stream(&errors);
+
+    std::vector<double> captured_latencies;
+    std::vector<double> replayed_latencies;
+    size_t error_count = 0;
+    size_t allocations = 0;
+
+    for (const ArgumentParser::CapturedCommandLine& command_line : command_lines) {
+        captured_latencies.push_back(command_line.latency.count());
+
+        for (int i = 0; i < repeat_count; i++) {
+            size_t allocations_before = Bench::allocation_count();
+            auto start = std::chrono::steady_clock::now();
+
+            bool is_parsed = job_parser->parse(command_line.tokens);
+
+            auto latency = std::chrono::steady_clock::now() - start;
+            allocations += Bench::allocation_count() - allocations_before;
+
+            replayed_latencies.push_back(std::chrono::duration<double, std::nano>(latency).count());
+            error_count += !is_parsed;
+        }
+
+        errors.str("");
+    }
+
+    size_t parse_count = replayed_latencies.size();
+    std::printf("Command lines: %zu, parses: %zu, errors: %zu, allocations per parse: %.1f\n",
+        command_lines.size(), parse_count, error_count, parse_count == 0 ? 0.0 : static_cast<double>(allocations) / parse_count);
+    report("captured", captured_latencies);
+    report("replayed", replayed_latencies);
+
+    return 0;
+}
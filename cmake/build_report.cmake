@@ -0,0 +1,45 @@
+# Writes per-TU compile times and the largest symbols of the library to REPORT.
+# Expects COMPILE_TIME_DIRECTORY, LIBRARY, NM and REPORT to be defined.
+
+cmake_policy(SET CMP0007 NEW)
+
+set(report "Compile time per translation unit (ms):\n")
+
+file(GLOB time_files "${COMPILE_TIME_DIRECTORY}/*.time")
+set(compile_times "")
+foreach(time_file ${time_files})
+    file(READ ${time_file} compile_time)
+    string(STRIP "${compile_time}" compile_time)
+    list(APPEND compile_times "${compile_time}")
+endforeach()
+
+list(SORT compile_times COMPARE NATURAL ORDER DESCENDING)
+foreach(compile_time ${compile_times})
+    string(APPEND report "    ${compile_time}\n")
+endforeach()
+
+execute_process(
+    COMMAND ${NM} --print-size --size-sort --reverse-sort --radix=d --demangle ${LIBRARY}
+    OUTPUT_VARIABLE symbols
+)
+
+# Demangled names may contain list separators.
+string(REPLACE ";" "," symbols "${symbols}")
+string(REPLACE "\n" ";" symbols "${symbols}")
+list(SUBLIST symbols 0 40 largest_symbols)
+
+set(total_size 0)
+foreach(symbol ${symbols})
+    if (symbol MATCHES "^[0-9]+ ([0-9]+) [tTwW] ")
+        math(EXPR total_size "${total_size} + ${CMAKE_MATCH_1}")
+    endif()
+endforeach()
+
+string(APPEND report "\nText symbols in ${LIBRARY}: ${total_size} bytes\n")
+string(APPEND report "\nLargest symbols (offset, size, type, name):\n")
+foreach(symbol ${largest_symbols})
+    string(APPEND report "    ${symbol}\n")
+endforeach()
+
+file(WRITE ${REPORT} "${report}")
+message("${report}")
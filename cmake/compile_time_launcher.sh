@@ -0,0 +1,28 @@
+#!/bin/sh
+# Compiler launcher that records how long each translation unit takes to compile.
+# Usage: compile_time_launcher.sh <log directory> <compiler command...>
+
+log_directory="$1"
+shift
+
+source_file=""
+previous_argument=""
+for argument in "$@"; do
+    if [ "$previous_argument" = "-c" ]; then
+        source_file="$argument"
+    fi
+    previous_argument="$argument"
+done
+
+start=$(date +%s%N)
+"$@"
+status=$?
+end=$(date +%s%N)
+
+if [ -n "$source_file" ]; then
+    mkdir -p "$log_directory"
+    log_name=$(echo "$source_file" | tr '/' '_')
+    echo "$(( (end - start) / 1000000 )) $source_file" > "$log_directory/$log_name.time"
+fi
+
+exit $status
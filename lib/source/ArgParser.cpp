@@ -2,31 +2,28 @@
 
 #include <iostream>
 #include <cstring>
+#include <bit>
+#include <unordered_map>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <typeinfo>
+#include <limits>
 
 #include "string_utils.h"
+#include "capture_log.h"
 
 bool starts_with(const char* string, const char* string1) {
     return !strncmp(string, string1, strlen(string1));
 }
 
-int32_t get_char_index(const char* string, const char character) {
-    size_t argument_length = strlen(string);
-    for (size_t i = 0; i < argument_length; i++) {
-        if (string[i] == '=') {
-            return i;
-        }
-    }
-
-    return -1;
-}
-
-const char* get_value_after_equals(const char* arg) {
-    int32_t equals_index = get_char_index(arg, '=');
-    if (equals_index == -1) {
+// Value attached to arg after its first '=', or null if there is none.
+const char* get_value_after_equals(std::string_view arg, size_t equals_index) {
+    if (equals_index == std::string_view::npos) {
         return nullptr;
     }
 
-    return arg + equals_index + 1;
+    return arg.data() + equals_index + 1;
 }
 
 bool is_argument_name_equal(const char* string, const char* expected_name) {
@@ -36,81 +33,240 @@ bool is_argument_name_equal(const char* string, const char* expected_name) {
 
 namespace ArgumentParser {
 
-const char* get_argument_name(ArgumentBase* argument) {
-    return (argument->get_name() != nullptr ? argument->get_name() : new char[] {argument->get_short_name()});
+std::string get_argument_name(ArgumentBase* argument) {
+    if (argument->get_name() != nullptr) {
+        return argument->get_name();
+    }
+
+    return std::string(1, argument->get_short_name());
 }
 
+namespace {
+
+size_t get_min_positional_count(ArgumentBase* argument) {
+    return argument->is_multi_value() ? argument->get_min_value_count() : 1;
+}
+
+size_t get_max_positional_count(ArgumentBase* argument) {
+    return argument->is_multi_value() ? argument->get_max_value_count() : 1;
+}
+
+} // namespace
+
 ArgParser::ArgParser(const char* name) {
     this->name = name;
-    this->arguments = new std::vector<ArgumentBase*>();
+    this->error_stream = &std::cerr;
 }
 
-ArgParser::~ArgParser() {
-    delete this->arguments;
-}
+ArgParser::~ArgParser() = default;
 
-bool ArgParser::parse_positional_arguments(std::vector<std::string_view>& arguments) {
-    std::vector<ArgumentBase*> positional_arguments;
+void ArgParser::register_argument(std::unique_ptr<ArgumentBase> argument) {
+    argument->set_index(this->arguments.size());
+    this->arguments.push_back(std::move(argument));
 
-    for (size_t i = 0; i < this->arguments->size(); i++) {
-        ArgumentBase* argument = (*this->arguments)[i];
-        if (argument->is_positional()) {
-            positional_arguments.push_back(argument);
-        }
+    this->is_name_trie_built = false;
+    this->are_constraints_compiled = false;
+    this->is_schema_hash_computed = false;
+    this->is_frozen = false;
+}
+
+void ArgParser::add_positional_token(size_t index) {
+    if (!this->positional_ranges.empty() && this->positional_ranges.back().end == index) {
+        this->positional_ranges.back().end++;
+        return;
     }
 
-    std::vector<ArgumentBase*> left_arguments;
-    ArgumentBase* multi_value_argument = nullptr;
-    std::vector<ArgumentBase*> right_arguments;
+    this->positional_ranges.push_back({index, index + 1});
+}
+
+bool ArgParser::parse_positional_arguments() {
+    size_t positional_count = 0;
+    for (const TokenRange& range : this->positional_ranges) {
+        positional_count += range.end - range.begin;
+    }
 
-    size_t i = 0;
-    while (i < positional_arguments.size()) {
-        ArgumentBase* positional_argument = positional_arguments[i];
-        if (positional_argument->is_multi_value()) {
-            break;
+    if (positional_count < this->positional_min_suffix[0]) {
+        size_t min_count = 0;
+        for (size_t index : this->positional_indices) {
+            min_count += get_min_positional_count(this->arguments[index].get());
+            if (min_count > positional_count) {
+                *this->error_stream << "Parsing error: argument value count is less than required. Argument name: " << get_argument_name(this->arguments[index].get()) << '\n';
+                return false;
+            }
         }
-        
-        left_arguments.push_back(positional_argument);
-        i++;
     }
 
-    if (i < positional_arguments.size()) {
-        multi_value_argument = positional_arguments[i];
-        ++i;
+    // Greedy split: up to the first unbounded positional, every positional takes as many tokens
+    // as it can while leaving the minimum of the ones after it.
+    size_t remaining_count = positional_count;
+    size_t forward_end = this->has_variadic_positional ? this->variadic_position : this->positional_indices.size();
+    for (size_t position = 0; position < forward_end; position++) {
+        ArgumentBase* argument = this->arguments[this->positional_indices[position]].get();
+        size_t count = std::min(get_max_positional_count(argument), remaining_count - this->positional_min_suffix[position + 1]);
+        this->positional_counts[position] = count;
+        remaining_count -= count;
     }
 
-    while (i < positional_arguments.size()) {
-        ArgumentBase* positional_argument = positional_arguments[i];
-        if (positional_argument->is_multi_value()) {
-            return false;
+    // The ones after it split the rest from the last backwards, each leaving the minimum of the
+    // ones between it and the unbounded positional, which takes whatever is left.
+    if (this->has_variadic_positional) {
+        for (size_t position = this->positional_indices.size(); --position > this->variadic_position;) {
+            ArgumentBase* argument = this->arguments[this->positional_indices[position]].get();
+            size_t reserved_count = this->positional_min_suffix[this->variadic_position] - this->positional_min_suffix[position];
+            size_t count = std::min(get_max_positional_count(argument), remaining_count - reserved_count);
+            this->positional_counts[position] = count;
+            remaining_count -= count;
         }
-        
-        right_arguments.push_back(positional_argument);
-        i++;
+
+        this->positional_counts[this->variadic_position] = remaining_count;
+        remaining_count = 0;
     }
 
-    if (arguments.size() < (left_arguments.size() + right_arguments.size())) {
+    if (remaining_count != 0) {
+        size_t ordinal = positional_count - remaining_count;
+        for (const TokenRange& range : this->positional_ranges) {
+            if (ordinal < range.end - range.begin) {
+                *this->error_stream << "Parsing error: too many positional arguments. Unexpected value: " << this->parsed_tokens[range.begin + ordinal] << '\n';
+                break;
+            }
+
+            ordinal -= range.end - range.begin;
+        }
+
         return false;
     }
 
-    for (size_t i = 0; i < left_arguments.size(); ++i) {
-        if (!left_arguments[i]->parse_value(arguments[i].data())) {
-            return false;
+    bool is_deferred = this->defer_multi_value_argument && this->has_variadic_positional;
+    size_t begin = 0;
+    for (size_t position = 0; position < this->positional_indices.size(); position++) {
+        ArgumentBase* argument = this->arguments[this->positional_indices[position]].get();
+        size_t count = this->positional_counts[position];
+
+        if (is_deferred && position == this->variadic_position) {
+            this->deferred_argument = argument;
+            this->deferred_begin = begin;
+            this->deferred_end = begin + count;
+
+            if (count != 0) {
+                this->present_arguments.set(argument->get_index());
+            }
+        } else if (count != 0 && argument->is_multi_value()) {
+            argument->reserve_values(count);
         }
+
+        begin += count;
     }
 
-    for (size_t i = 0; i < right_arguments.size(); ++i) {
-        if (!right_arguments[right_arguments.size() - i - 1]->parse_value(arguments[arguments.size() - i - 1].data())) {
-            return false;
+    size_t ordinal = 0;
+    size_t position = 0;
+    size_t position_end = this->positional_counts.empty() ? 0 : this->positional_counts[0];
+    for (const TokenRange& range : this->positional_ranges) {
+        for (size_t i = range.begin; i < range.end; i++, ordinal++) {
+            while (ordinal == position_end) {
+                position_end += this->positional_counts[++position];
+            }
+
+            if (is_deferred && position == this->variadic_position) {
+                continue;
+            }
+
+            if (!this->parse_argument_value(this->arguments[this->positional_indices[position]].get(), this->parsed_tokens[i].data())) {
+                return false;
+            }
         }
     }
 
-    for (size_t i = left_arguments.size(); i < arguments.size() - right_arguments.size(); ++i) {
-        if (!multi_value_argument->parse_value(arguments[i].data())) {
+    return true;
+}
+
+bool ArgParser::parse_argument_value(ArgumentBase* argument, const char* value) {
+    // Values copied by parse_incremental are already in place.
+    if (this->is_reusing_values && this->reused_arguments.test(argument->get_index())) {
+        this->present_arguments.set(argument->get_index());
+        return true;
+    }
+
+    if (!argument->parse_value(value, *this->error_stream)) {
+        if (!argument->reports_conversion_errors()) {
+            *this->error_stream << "Parsing error: invalid value '" << (value != nullptr ? value : "") << "'. Argument name: " << get_argument_name(argument) << '\n';
+        }
+
+        return false;
+    }
+
+    this->present_arguments.set(argument->get_index());
+    return true;
+}
+
+bool ArgParser::freeze() {
+    this->is_frozen = false;
+    this->positional_indices.clear();
+    this->variadic_position = 0;
+    this->has_variadic_positional = false;
+    this->min_count_indices.clear();
+    this->long_name_indices.clear();
+    this->long_name_indices.reserve(this->arguments.size());
+    this->short_name_arguments.fill(nullptr);
+
+    ArgumentMask required_arguments;
+
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        ArgumentBase* argument = this->arguments[i].get();
+
+        if (argument->get_name() != nullptr && !this->long_name_indices.emplace(argument->get_name(), i).second) {
+            *this->error_stream << "Schema error: duplicate argument name: " << argument->get_name() << '\n';
             return false;
         }
+
+        unsigned char short_name = argument->get_short_name();
+        if (short_name != 0) {
+            if (this->short_name_arguments[short_name] != nullptr) {
+                *this->error_stream << "Schema error: duplicate short argument name: " << argument->get_short_name() << '\n';
+                return false;
+            }
+
+            this->short_name_arguments[short_name] = argument;
+        }
+
+        if (argument->is_positional()) {
+            size_t min_count = get_min_positional_count(argument);
+            size_t max_count = get_max_positional_count(argument);
+            if (min_count > max_count) {
+                *this->error_stream << "Schema error: minimum value count is greater than maximum. Argument name: " << get_argument_name(argument) << '\n';
+                return false;
+            }
+
+            if (!this->has_variadic_positional && max_count == std::numeric_limits<size_t>::max()) {
+                this->variadic_position = this->positional_indices.size();
+                this->has_variadic_positional = true;
+            }
+
+            this->positional_indices.push_back(i);
+        }
+
+        if (argument->is_multi_value()) {
+            if (argument->get_min_value_count() > 0) {
+                this->min_count_indices.push_back(i);
+            }
+        } else if (argument->should_have_argument() && !argument->has_default_value()) {
+            required_arguments.set(i);
+        }
     }
 
+    this->positional_min_suffix.assign(this->positional_indices.size() + 1, 0);
+    for (size_t position = this->positional_indices.size(); position-- > 0;) {
+        size_t min_count = get_min_positional_count(this->arguments[this->positional_indices[position]].get());
+        this->positional_min_suffix[position] = this->positional_min_suffix[position + 1] + min_count;
+    }
+
+    this->positional_counts.assign(this->positional_indices.size(), 0);
+
+    if (!this->are_constraints_compiled && !this->compile_constraints()) {
+        return false;
+    }
+
+    this->required_mask = required_arguments.to_sparse();
+    this->is_frozen = true;
     return true;
 }
 
@@ -119,34 +275,255 @@ bool ArgParser::validate_arguments() {
         return true;
     }
 
-    for (size_t i = 0; i < this->arguments->size(); i++) {
-        ArgumentBase* argument = (*this->arguments)[i];
-        if (argument->is_multi_value()) {
-            if (argument->get_value_count() < argument->get_min_value_count()) {
-                std::cerr << "Parsing error: argument value count is less than required. Argument name: " << get_argument_name(argument) << '\n';
+    if (!this->present_arguments.contains(this->required_mask)) {
+        for (const MaskWord& word : this->required_mask) {
+            uint64_t bits = word.bits;
+            while (bits != 0) {
+                size_t index = word.index * 64 + std::countr_zero(bits);
+                bits &= bits - 1;
+
+                if (!this->present_arguments.test(index)) {
+                    *this->error_stream << "Parsing error: argument value not found. Argument name: " << get_argument_name(this->arguments[index].get()) << '\n';
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (size_t index : this->min_count_indices) {
+        ArgumentBase* argument = this->arguments[index].get();
+        size_t value_count = argument->get_parsed_value_count();
+        if (argument == this->deferred_argument) {
+            value_count = this->deferred_end - this->deferred_begin;
+        }
+
+        if (value_count < argument->get_min_value_count()) {
+            *this->error_stream << "Parsing error: argument value count is less than required. Argument name: " << get_argument_name(argument) << '\n';
+            return false;
+        }
+    }
+
+    if (!this->validate_constraints()) {
+        return false;
+    }
+
+    return this->run_validators();
+}
+
+// A validator shared between the parser and the thread running it, so that the parser can stop
+// waiting on timeout while the thread still finishes.
+struct ValidationTask {
+    std::function<bool(std::string& error)> validate;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    bool is_done = false;
+    bool is_valid = false;
+    std::string error;
+    std::chrono::nanoseconds duration = std::chrono::nanoseconds(0);
+
+    void run() {
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        bool is_valid = this->validate(error);
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        std::lock_guard lock(this->mutex);
+        this->is_valid = is_valid;
+        this->error = std::move(error);
+        this->duration = duration;
+        this->is_done = true;
+        this->done.notify_all();
+    }
+};
+
+struct ValidationThread {
+    std::shared_ptr<ValidationTask> task;
+    std::jthread thread;
+};
+
+bool ArgParser::run_validators() {
+    this->validation_results.clear();
+
+    // Threads left running by timed out validators of earlier parses are joined once they finish.
+    std::erase_if(this->validation_threads, [](const std::unique_ptr<ValidationThread>& validation_thread) {
+        std::lock_guard lock(validation_thread->task->mutex);
+        return validation_thread->task->is_done;
+    });
+
+    std::vector<std::shared_ptr<ValidationTask>> tasks;
+    std::vector<ArgumentBase*> validated_arguments;
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        std::function<bool(std::string&)> validate = this->arguments[i]->make_validation_task();
+        if (!validate) {
+            continue;
+        }
+
+        auto task = std::make_shared<ValidationTask>();
+        task->validate = std::move(validate);
+        tasks.push_back(std::move(task));
+        validated_arguments.push_back(this->arguments[i].get());
+
+        ValidationResult& result = this->validation_results.emplace_back();
+        result.argument_name = this->arguments[i]->get_name();
+    }
+
+    if (tasks.empty()) {
+        return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + this->validation_timeout;
+    if (this->is_validation_concurrent) {
+        for (const std::shared_ptr<ValidationTask>& task : tasks) {
+            this->validation_threads.push_back(std::make_unique<ValidationThread>(task, std::jthread([task] {
+                task->run();
+            })));
+        }
+    }
+
+    bool is_valid = true;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        ValidationTask& task = *tasks[i];
+        ValidationResult& result = this->validation_results[i];
+
+        if (!this->is_validation_concurrent) {
+            task.run();
+        }
+
+        std::unique_lock lock(task.mutex);
+        if (this->validation_timeout.count() == 0) {
+            task.done.wait(lock, [&task] { return task.is_done; });
+        } else if (!task.done.wait_until(lock, deadline, [&task] { return task.is_done; })) {
+            result.is_timed_out = true;
+        }
+
+        if (task.is_done) {
+            result.is_valid = task.is_valid;
+            result.error = task.error;
+            result.duration = task.duration;
+        }
+
+        if (task.is_done && this->validation_timeout.count() != 0 && task.duration > this->validation_timeout) {
+            result.is_timed_out = true;
+        }
+
+        if (result.is_timed_out) {
+            result.is_valid = false;
+            result.error = "validator timed out";
+            if (!task.is_done) {
+                result.duration = this->validation_timeout;
+            }
+        }
+
+        if (!result.is_valid) {
+            *this->error_stream << "Validation error: " << result.error << ". Argument name: " << get_argument_name(validated_arguments[i]) << '\n';
+            is_valid = false;
+        }
+    }
+
+    return is_valid;
+}
+
+// Names of the arguments in mask, optionally only those also set in filter.
+std::string describe_arguments(const std::vector<std::unique_ptr<ArgumentBase>>& arguments, const std::vector<MaskWord>& mask, const ArgumentMask* filter = nullptr) {
+    std::string description;
+
+    for (const MaskWord& word : mask) {
+        uint64_t bits = word.bits;
+        while (bits != 0) {
+            size_t index = word.index * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+
+            if (filter != nullptr && !filter->test(index)) {
+                continue;
+            }
+
+            if (!description.empty()) {
+                description += ", ";
+            }
+
+            description += get_argument_name(arguments[index].get());
+        }
+    }
+
+    return description;
+}
+
+bool ArgParser::compile_constraints() {
+    // Called by freeze once long_name_indices is built.
+    auto compile_mask = [&](const std::vector<const char*>& argument_names, std::vector<MaskWord>& mask) {
+        ArgumentMask dense_mask;
+        for (const char* argument_name : argument_names) {
+            auto iterator = this->long_name_indices.find(argument_name);
+            if (iterator == this->long_name_indices.end()) {
+                *this->error_stream << "Constraint error: unknown argument name: " << argument_name << '\n';
                 return false;
             }
-        } else if (argument->should_have_argument() && !argument->has_value() && !argument->has_default_value()) {
-            std::cerr << "Parsing error: argument value not found. Argument name: " << get_argument_name(argument) << '\n';
+
+            dense_mask.set(iterator->second);
+        }
+
+        mask = dense_mask.to_sparse();
+        return true;
+    };
+
+    for (ArgumentConstraint& constraint : this->constraints) {
+        if (!compile_mask(constraint.trigger_names, constraint.trigger_mask) || !compile_mask(constraint.argument_names, constraint.mask)) {
             return false;
         }
     }
 
+    this->are_constraints_compiled = true;
+    return true;
+}
+
+bool ArgParser::validate_constraints() {
+    if (this->constraints.empty()) {
+        return true;
+    }
+
+    if (!this->are_constraints_compiled && !this->compile_constraints()) {
+        return false;
+    }
+
+    for (const ArgumentConstraint& constraint : this->constraints) {
+        switch (constraint.kind) {
+            case ArgumentConstraint::Kind::MutuallyExclusive:
+                if (this->present_arguments.count_common(constraint.mask) > 1) {
+                    *this->error_stream << "Parsing error: arguments are mutually exclusive: " << describe_arguments(this->arguments, constraint.mask, &this->present_arguments) << '\n';
+                    return false;
+                }
+                break;
+            case ArgumentConstraint::Kind::Requires:
+                if (this->present_arguments.contains(constraint.trigger_mask) && !this->present_arguments.contains(constraint.mask)) {
+                    *this->error_stream << "Parsing error: argument " << describe_arguments(this->arguments, constraint.trigger_mask) << " requires: " << describe_arguments(this->arguments, constraint.mask) << '\n';
+                    return false;
+                }
+                break;
+            case ArgumentConstraint::Kind::AtLeastOneOf:
+                if (this->present_arguments.count_common(constraint.mask) == 0) {
+                    *this->error_stream << "Parsing error: at least one of the arguments is required: " << describe_arguments(this->arguments, constraint.mask) << '\n';
+                    return false;
+                }
+                break;
+        }
+    }
+
     return true;
 }
 
-bool ArgParser::handle_argument_value(ArgumentBase* argument, const std::string_view& arg, const std::string_view& next_arg) {
+bool ArgParser::handle_argument_value(ArgumentBase* argument, const char* attached_value, const std::string_view& next_arg) {
     const char* value = nullptr;
     if (argument->should_have_argument()) {
-        value = get_value_after_equals(arg.data());
+        value = attached_value;
         if (value == nullptr) {
             if (!next_arg.size()) {
-                std::cerr << "Missing expected argument: argument count is too low." << '\n';
+                *this->error_stream << "Missing expected argument: argument count is too low." << '\n';
                 return false;
             }
 
             if (next_arg[0] == '-') {
-                std::cerr << "Missing expected argument: next argument is not a value." << '\n';
+                *this->error_stream << "Missing expected argument: next argument is not a value." << '\n';
                 return false;
             }
 
@@ -155,20 +532,19 @@ bool ArgParser::handle_argument_value(ArgumentBase* argument, const std::string_
         } 
         
         if (value == nullptr) {
-            std::cerr << "Missing expected argument: argument value not found." << '\n';
+            *this->error_stream << "Missing expected argument: argument value not found." << '\n';
             return false;
         }
     } else {
         this->may_next_argument_be_free = true;
     }
 
-    argument->parse_value(value);
-    return true;
+    return this->parse_argument_value(argument, value);
 }
 
 ArgumentBase* ArgParser::find_argument_by_name(const char* argument_name) {    
-    for (size_t i = 0; i < this->arguments->size(); i++) {
-        ArgumentBase* argument = (*this->arguments)[i];
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        ArgumentBase* argument = this->arguments[i].get();
         if (is_argument_name_equal(argument_name, argument->get_name()) || (argument_name[0] == argument->get_short_name())) {
             return argument;
         }
@@ -180,55 +556,313 @@ ArgumentBase* ArgParser::find_argument_by_name(const char* argument_name) {
     return nullptr;
 }
 
-ArgumentBase* ArgParser::find_argument_by_full_name(const char* argument_name) {    
-    for (size_t i = 0; i < this->arguments->size(); i++) {
-        ArgumentBase* argument = (*this->arguments)[i];
-        if (is_argument_name_equal(argument_name, argument->get_name())) {
-            return argument;
+ArgumentBase* ArgParser::find_argument_by_full_name(std::string_view argument_name) {
+    if (this->allow_abbreviations) {
+        std::string_view name = argument_name.substr(0, argument_name.find('='));
+
+        NameMatch match = this->get_name_trie().find(name);
+        if (match.found) {
+            return this->arguments[match.argument_index].get();
+        }
+
+        if (match.candidates.size() > 1) {
+            *this->error_stream << "Ambiguous argument name: " << name << ". Candidates:";
+            for (const IndexedName& candidate : match.candidates) {
+                *this->error_stream << " --" << candidate.first;
+            }
+            *this->error_stream << '\n';
+        } else {
+            *this->error_stream << "Unknown argument name: " << name << '\n';
         }
+
+        return nullptr;
     }
 
+    std::string_view name = argument_name.substr(0, argument_name.find('='));
+    auto found = this->long_name_indices.find(name);
+    if (found != this->long_name_indices.end()) {
+        return this->arguments[found->second].get();
+    }
+
+    *this->error_stream << "Unknown argument name: " << name << '\n';
     return nullptr;
 }
 
-ArgumentBase* ArgParser::find_argument_by_short_name(const char argument_name) {    
-    for (size_t i = 0; i < this->arguments->size(); i++) {
-        ArgumentBase* argument = (*this->arguments)[i];
-        if (argument_name == argument->get_short_name()) {
-            return argument;
+ArgumentBase* ArgParser::find_argument_by_short_name(const char argument_name) {
+    return this->short_name_arguments[static_cast<unsigned char>(argument_name)];
+}
+
+ArgumentBase* ArgParser::lookup_long_name(std::string_view name) {
+    if (this->allow_abbreviations) {
+        NameMatch match = this->get_name_trie().find(name);
+        return match.found ? this->arguments[match.argument_index].get() : nullptr;
+    }
+
+    auto found = this->long_name_indices.find(name);
+    return found != this->long_name_indices.end() ? this->arguments[found->second].get() : nullptr;
+}
+
+const NameTrie& ArgParser::get_name_trie() {
+    if (!this->is_name_trie_built) {
+        std::vector<IndexedName> names;
+        for (size_t i = 0; i < this->arguments.size(); i++) {
+            if (this->arguments[i]->get_name() != nullptr) {
+                names.emplace_back(this->arguments[i]->get_name(), i);
+            }
         }
+
+        this->name_trie.build(std::move(names));
+        this->is_name_trie_built = true;
     }
 
-    return nullptr;
+    return this->name_trie;
 }
 
-bool ArgParser::parse(int argc, const char** argv) {
-    std::vector<std::string_view> string_views;
+CompletionResult ArgParser::complete(std::span<const char* const> args, size_t cursor_index) {
+    return this->complete_tokens(args, cursor_index);
+}
+
+CompletionResult ArgParser::complete(const std::vector<std::string>& args, size_t cursor_index) {
+    return this->complete_tokens(std::span<const std::string>(args), cursor_index);
+}
+
+CompletionResult ArgParser::complete_tokens(const TokenList& args, size_t cursor_index) {
+    CompletionResult result;
+    if (cursor_index == 0) {
+        return result;
+    }
+
+    if (!this->is_frozen) {
+        // Schema errors are left for parse to report; completion just finds nothing.
+        std::ostream discarded(nullptr);
+        std::ostream* error_stream = this->error_stream;
+        this->error_stream = &discarded;
+        bool is_frozen = this->freeze();
+        this->error_stream = error_stream;
+
+        if (!is_frozen) {
+            return result;
+        }
+    }
+
+    // The tokens before the cursor, read like parse_tokens does. Unknown names and missing values are skipped.
+    ArgumentMask present;
+    present.reset(this->arguments.size());
+    ArgumentBase* pending_argument = nullptr;
+    bool is_positional_only = false;
+    size_t positional_count = 0;
+
+    for (size_t i = 1; i < std::min(cursor_index, args.size()); i++) {
+        std::string_view arg = args[i];
+        if (pending_argument != nullptr && !arg.starts_with('-')) {
+            pending_argument = nullptr;
+            continue;
+        }
+
+        pending_argument = nullptr;
+        if (is_positional_only || !arg.starts_with('-') || arg.size() == 1) {
+            positional_count++;
+            continue;
+        }
+
+        if (arg == "--") {
+            is_positional_only = true;
+            continue;
+        }
+
+        size_t equals_index = arg.find('=');
+        if (arg.starts_with("--")) {
+            ArgumentBase* argument = this->lookup_long_name(arg.substr(2, equals_index == std::string_view::npos ? equals_index : equals_index - 2));
+            if (argument != nullptr) {
+                present.set(argument->get_index());
+                if (argument->should_have_argument() && equals_index == std::string_view::npos) {
+                    pending_argument = argument;
+                }
+            }
+
+            continue;
+        }
+
+        size_t arg_length = std::min(equals_index, arg.size());
+        for (size_t j = 1; j < arg_length; j++) {
+            ArgumentBase* argument = this->find_argument_by_short_name(arg[j]);
+            if (argument != nullptr) {
+                present.set(argument->get_index());
+                if (arg_length == 2 && argument->should_have_argument() && equals_index == std::string_view::npos) {
+                    pending_argument = argument;
+                }
+            }
+        }
+    }
+
+    // Options given once are not offered again, nor are the others of their mutually exclusive groups.
+    ArgumentMask excluded;
+    excluded.reset(this->arguments.size());
+    for (const ArgumentConstraint& constraint : this->constraints) {
+        if (constraint.kind != ArgumentConstraint::Kind::MutuallyExclusive || present.count_common(constraint.mask) == 0) {
+            continue;
+        }
+
+        for (const MaskWord& word : constraint.mask) {
+            uint64_t bits = word.bits;
+            while (bits != 0) {
+                excluded.set(word.index * 64 + std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    auto is_offered = [&](ArgumentBase* argument) {
+        size_t index = argument->get_index();
+        if (argument->is_positional() || (excluded.test(index) && !present.test(index))) {
+            return false;
+        }
+
+        return !present.test(index) || argument->is_multi_value();
+    };
+
+    auto add_values = [&result](ArgumentBase* argument, std::string_view prefix) {
+        result.value_argument = argument;
+        for (std::string_view choice : argument->get_choices()) {
+            if (choice.starts_with(prefix)) {
+                result.values.push_back(choice);
+            }
+        }
+    };
+
+    auto add_long_options = [&](std::string_view prefix) {
+        std::span<const IndexedName> candidates = this->get_name_trie().find(prefix).candidates;
+        result.options.reserve(result.options.size() + candidates.size());
+
+        for (const IndexedName& name : candidates) {
+            if (is_offered(this->arguments[name.second].get())) {
+                std::string& option = result.options.emplace_back();
+                option.reserve(name.first.size() + 2);
+                option.append("--").append(name.first);
+            }
+        }
+    };
+
+    std::string_view word;
+    if (cursor_index < args.size()) {
+        word = args[cursor_index];
+    }
+
+    bool is_option = !is_positional_only && word.starts_with('-');
+    if (pending_argument != nullptr && !is_option) {
+        add_values(pending_argument, word);
+        return result;
+    }
+
+    if (!is_option) {
+        // The positional argument the token would be a value of: the first one not yet given its
+        // maximum count, as the later tokens are not known.
+        size_t max_count = 0;
+        for (size_t index : this->positional_indices) {
+            ArgumentBase* argument = this->arguments[index].get();
+            max_count += std::min(get_max_positional_count(argument), std::numeric_limits<size_t>::max() - max_count);
+            if (positional_count < max_count) {
+                add_values(argument, word);
+                break;
+            }
+        }
+
+        if (word.empty() && !is_positional_only) {
+            add_long_options("");
+        }
+
+        return result;
+    }
+
+    size_t equals_index = word.find('=');
+    if (word.starts_with("--")) {
+        if (equals_index == std::string_view::npos) {
+            add_long_options(word.substr(2));
+        } else {
+            ArgumentBase* argument = this->lookup_long_name(word.substr(2, equals_index - 2));
+            if (argument != nullptr && argument->should_have_argument()) {
+                add_values(argument, word.substr(equals_index + 1));
+            }
+        }
+
+        return result;
+    }
+
+    if (word.size() == 1) {
+        for (const std::unique_ptr<ArgumentBase>& argument : this->arguments) {
+            if (argument->get_short_name() != 0 && is_offered(argument.get())) {
+                result.options.push_back(std::string(1, '-') + argument->get_short_name());
+            }
+        }
 
-    for (size_t i = 0; i < argc; i++) {
-        string_views.emplace_back(argv[i]);
+        add_long_options("");
+    } else if (equals_index == 2) {
+        ArgumentBase* argument = this->find_argument_by_short_name(word[1]);
+        if (argument != nullptr && argument->should_have_argument()) {
+            add_values(argument, word.substr(3));
+        }
     }
 
-    return this->parse(string_views);
+    return result;
+}
+
+bool ArgParser::parse(int argc, const char** argv) {
+    return this->parse(std::span<const char* const>(argv, argc));
 }
 
 bool ArgParser::parse(const std::vector<std::string>& args) {
-    std::vector<std::string_view> string_views;
+    return this->parse_token_list(std::span<const std::string>(args));
+}
+
+bool ArgParser::parse(std::span<const char* const> args) {
+    return this->parse_token_list(args);
+}
 
-    for (auto& arg : args) {
-        string_views.emplace_back(arg);
+bool ArgParser::parse(std::span<const std::string_view> args) {
+    return this->parse_token_list(this->copy_tokens(args));
+}
+
+std::span<const std::string_view> ArgParser::copy_tokens(std::span<const std::string_view> args) {
+    size_t byte_count = 0;
+    for (std::string_view arg : args) {
+        byte_count += arg.size() + 1;
     }
 
-    return this->parse(string_views);
+    this->owned_token_bytes.clear();
+    this->owned_token_bytes.reserve(byte_count);
+    this->owned_tokens.clear();
+
+    // Reserved up front, so the views taken while appending stay valid.
+    for (std::string_view arg : args) {
+        size_t offset = this->owned_token_bytes.size();
+        this->owned_token_bytes.append(arg);
+        this->owned_token_bytes.push_back('\0');
+        this->owned_tokens.emplace_back(this->owned_token_bytes.data() + offset, arg.size());
+    }
+
+    return this->owned_tokens;
+}
+
+bool ArgParser::parse_token_list(const TokenList& args) {
+    CaptureLog* capture_log = CaptureLog::from_environment(*this->error_stream);
+    if (capture_log == nullptr) {
+        return this->parse_cached(args);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool result = this->parse_cached(args);
+    capture_log->append(args, std::chrono::steady_clock::now() - start, result);
+
+    return result;
 }
 
 bool ArgParser::parse_argument(const std::string_view& arg, const std::string_view& next_arg) {
-    ArgumentBase* argument = this->find_argument_by_full_name(arg.substr(2).data());
+    ArgumentBase* argument = this->find_argument_by_full_name(arg.substr(2));
     if (argument == nullptr) {
         return false;
     }
 
-    return this->handle_argument_value(argument, arg, next_arg);
+    return this->handle_argument_value(argument, get_value_after_equals(arg, arg.find('=')), next_arg);
 }
 
 bool ArgParser::parse_short_argument(const std::string_view& arg, const std::string_view& next_arg) {
@@ -237,24 +871,22 @@ bool ArgParser::parse_short_argument(const std::string_view& arg, const std::str
     if (equals_index != std::string_view::npos) {
         arg_length = equals_index;
     }
-    
+
+    const char* attached_value = get_value_after_equals(arg, equals_index);
+
     for (size_t i = 1; i < arg_length; i++) {
         ArgumentBase* argument = this->find_argument_by_short_name(arg[i]);
         if (argument == nullptr) {
-            return false;
-        }
-        
-        if (argument == nullptr) {
-            std::cerr << "Unknown short argument name: " << arg[i] << '\n';
+            *this->error_stream << "Unknown short argument name: " << arg[i] << '\n';
             return false;
         }
 
         if (argument->should_have_argument() && arg_length > 2) {
-            std::cerr << "An argument with a value cannot be merged with others.\n";
+            *this->error_stream << "An argument with a value cannot be merged with others.\n";
             return false;
         }
         
-        if (!this->handle_argument_value(argument, arg, next_arg)) {
+        if (!this->handle_argument_value(argument, attached_value, next_arg)) {
             return false;
         }
     }
@@ -262,21 +894,78 @@ bool ArgParser::parse_short_argument(const std::string_view& arg, const std::str
     return true;
 }
 
-bool ArgParser::parse(const std::vector<std::string_view>& args) {
+bool ArgParser::parse_cached(const TokenList& args) {
+    if (this->parse_cache == nullptr || this->defer_multi_value_argument) {
+        return this->parse_tokens(args);
+    }
+
+    uint64_t fingerprint = ParseCache::fingerprint(args);
+
+    const std::vector<std::byte>* snapshot = this->parse_cache->find(fingerprint, args);
+    if (snapshot != nullptr && this->read_snapshot(*snapshot, false)) {
+        // Validators check the environment, e.g. that a path exists, so they run on every parse.
+        return this->run_validators();
+    }
+
+    if (!this->parse_tokens(args)) {
+        return false;
+    }
+
+    std::vector<std::byte> parsed_snapshot;
+    if (this->write_snapshot(parsed_snapshot, false)) {
+        this->parse_cache->insert(fingerprint, args, std::move(parsed_snapshot));
+    }
+
+    return true;
+}
+
+bool ArgParser::parse_tokens(const TokenList& args) {
+    if (!this->is_frozen && !this->freeze()) {
+        return false;
+    }
+
     this->may_next_argument_be_free = true;
     bool is_positional_only = false;
 
-    std::vector<std::string_view> positional_arguments;
+    // store_values vectors are appended to, except by parse_incremental, which rebuilds the whole
+    // parsed state from the previous parser.
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        if (!this->is_reusing_values || !this->reused_arguments.test(i)) {
+            this->arguments[i]->clear_values(this->is_reusing_values);
+        }
+    }
+
+    if (this->is_reusing_values) {
+        // Tokens of the reused arguments may be left out, so their presence is taken over too.
+        this->present_arguments = this->reused_present_arguments;
+    } else {
+        this->present_arguments.reset(this->arguments.size());
+    }
+
+    this->validation_results.clear();
+
+    this->parsed_tokens = args;
+    this->positional_ranges.clear();
+
+    this->deferred_argument = nullptr;
+    this->deferred_begin = 0;
+    this->deferred_end = 0;
+
+    // Each token is viewed once, as next_arg, and carried over to the next iteration.
+    std::string_view next_arg;
+    if (args.size() > 1) {
+        next_arg = args[1];
+    }
 
     for (size_t i = 1; i < args.size(); i++) {
-        std::string_view arg = args[i];
-        std::string_view next_arg;
+        std::string_view arg = next_arg;
+        next_arg = {};
         if (i + 1 < args.size()) {
             next_arg = args[i + 1];
         }
 
         if (is_positional_only) {
-            positional_arguments.push_back(arg);
+            this->add_positional_token(i);
         } else if (arg.starts_with("--")) {
             if (arg.size() == 2) {
                 is_positional_only = true;
@@ -292,20 +981,299 @@ bool ArgParser::parse(const std::vector<std::string_view>& args) {
             }
         } else {
             if (this->may_next_argument_be_free) {
-                positional_arguments.push_back(arg);
+                this->add_positional_token(i);
             }
 
             this->may_next_argument_be_free = true;
         }
     }
 
-    if (!this->parse_positional_arguments(positional_arguments)) {
+    if (!this->parse_positional_arguments()) {
         return false;
     }
 
     return this->validate_arguments();
 }
 
+bool ArgParser::parse_incremental(std::span<const std::string_view> args, ArgParser& previous, std::span<const std::string_view> reparsed_names, std::vector<const char*>& changed_names) {
+    changed_names.clear();
+    if (!this->is_frozen && !this->freeze()) {
+        return false;
+    }
+
+    // Checked argument by argument: hashing the whole schema costs about as much as a full parse.
+    if (previous.arguments.size() != this->arguments.size()) {
+        *this->error_stream << "Parsing error: previous parser has a different schema.\n";
+        return false;
+    }
+
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        ArgumentBase& argument = *this->arguments[i];
+        ArgumentBase& previous_argument = *previous.arguments[i];
+        const char* argument_name = argument.get_name();
+        const char* previous_name = previous_argument.get_name();
+        bool is_same_name = argument_name == previous_name
+            || (argument_name != nullptr && previous_name != nullptr && std::strcmp(argument_name, previous_name) == 0);
+
+        if (typeid(argument) != typeid(previous_argument) || !is_same_name || argument.get_short_name() != previous_argument.get_short_name()) {
+            *this->error_stream << "Parsing error: previous parser has a different schema.\n";
+            return false;
+        }
+    }
+
+    this->reused_arguments.reset(this->arguments.size());
+    this->reused_present_arguments.reset(this->arguments.size());
+
+    ArgumentMask reparsed_arguments;
+    reparsed_arguments.reset(this->arguments.size());
+    for (std::string_view name : reparsed_names) {
+        ArgumentBase* argument = this->lookup_long_name(name);
+        if (argument != nullptr) {
+            reparsed_arguments.set(argument->get_index());
+        }
+    }
+
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        if (reparsed_arguments.test(i)) {
+            continue;
+        }
+
+        this->arguments[i]->copy_state(*previous.arguments[i]);
+        this->reused_arguments.set(i);
+        if (previous.present_arguments.test(i)) {
+            this->reused_present_arguments.set(i);
+        }
+    }
+
+    this->is_reusing_values = true;
+    bool result = this->parse_tokens(this->copy_tokens(args));
+    this->is_reusing_values = false;
+
+    if (!result) {
+        return false;
+    }
+
+    std::vector<std::byte> state;
+    std::vector<std::byte> previous_state;
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        if (this->reused_arguments.test(i)) {
+            continue;
+        }
+
+        state.clear();
+        previous_state.clear();
+        SnapshotWriter writer(state);
+        SnapshotWriter previous_writer(previous_state);
+        if (!this->arguments[i]->save_state(writer) || !previous.arguments[i]->save_state(previous_writer) || state != previous_state) {
+            changed_names.push_back(this->arguments[i]->get_name());
+        }
+    }
+
+    return true;
+}
+
+bool ArgParser::parse_lazy(int argc, const char** argv) {
+    return this->parse_lazy(std::span<const char* const>(argv, argc));
+}
+
+bool ArgParser::parse_lazy(std::span<const char* const> args) {
+    return this->parse_lazy_tokens(args);
+}
+
+bool ArgParser::parse_lazy(std::span<const std::string_view> args) {
+    return this->parse_lazy_tokens(this->copy_tokens(args));
+}
+
+bool ArgParser::parse_lazy_tokens(const TokenList& args) {
+    this->defer_multi_value_argument = true;
+    bool result = this->parse_token_list(args);
+    this->defer_multi_value_argument = false;
+
+    return result;
+}
+
+void ArgParser::add_mutually_exclusive_group(std::initializer_list<const char*> argument_names) {
+    this->constraints.push_back({ArgumentConstraint::Kind::MutuallyExclusive, {}, argument_names});
+    this->are_constraints_compiled = false;
+    // Completion reads the compiled constraints once frozen, so the next use freezes again.
+    this->is_frozen = false;
+
+    if (this->parse_cache != nullptr) {
+        this->parse_cache->clear();
+    }
+}
+
+void ArgParser::add_requirement(const char* argument_name, std::initializer_list<const char*> required_argument_names) {
+    this->constraints.push_back({ArgumentConstraint::Kind::Requires, {argument_name}, required_argument_names});
+    this->are_constraints_compiled = false;
+    this->is_frozen = false;
+
+    if (this->parse_cache != nullptr) {
+        this->parse_cache->clear();
+    }
+}
+
+void ArgParser::add_at_least_one_of_group(std::initializer_list<const char*> argument_names) {
+    this->constraints.push_back({ArgumentConstraint::Kind::AtLeastOneOf, {}, argument_names});
+    this->are_constraints_compiled = false;
+    this->is_frozen = false;
+
+    if (this->parse_cache != nullptr) {
+        this->parse_cache->clear();
+    }
+}
+
+const uint32_t SNAPSHOT_MAGIC = 0x53504741; // "AGPS"
+const uint32_t SNAPSHOT_VERSION = 1;
+
+uint64_t ArgParser::get_schema_hash() {
+    if (this->is_schema_hash_computed) {
+        return this->schema_hash;
+    }
+
+    uint64_t hash = hash_string("", this->arguments.size());
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        hash = hash_string("", hash ^ this->arguments[i]->get_schema_hash());
+    }
+
+    this->schema_hash = hash;
+    this->is_schema_hash_computed = true;
+    return hash;
+}
+
+bool ArgParser::write_snapshot(std::vector<std::byte>& snapshot, bool report_errors) {
+    snapshot.clear();
+
+    SnapshotWriter writer(snapshot);
+    writer.write(SNAPSHOT_MAGIC);
+    writer.write(SNAPSHOT_VERSION);
+    writer.write(this->get_schema_hash());
+
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        writer.write<uint8_t>(this->present_arguments.test(i));
+
+        if (!this->arguments[i]->save_state(writer)) {
+            if (report_errors) {
+                *this->error_stream << "Snapshot error: argument value type cannot be saved. Argument name: " << get_argument_name(this->arguments[i].get()) << '\n';
+            }
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ArgParser::read_snapshot(std::span<const std::byte> snapshot, bool report_errors) {
+    SnapshotReader reader(snapshot);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t schema_hash = 0;
+    if (!reader.read(magic) || !reader.read(version) || !reader.read(schema_hash) || magic != SNAPSHOT_MAGIC) {
+        if (report_errors) {
+            *this->error_stream << "Snapshot error: not an argument parser snapshot.\n";
+        }
+
+        return false;
+    }
+
+    if (version != SNAPSHOT_VERSION || schema_hash != this->get_schema_hash()) {
+        if (report_errors) {
+            *this->error_stream << "Snapshot error: snapshot was made by a different parser schema.\n";
+        }
+
+        return false;
+    }
+
+    // The whole snapshot is checked before any argument is changed, so a truncated or corrupted
+    // one leaves the parser as it was.
+    SnapshotReader checker = reader;
+    bool is_valid = true;
+    for (size_t i = 0; i < this->arguments.size() && is_valid; i++) {
+        uint8_t is_present = 0;
+        is_valid = checker.read(is_present) && is_present <= 1 && this->arguments[i]->skip_state(checker);
+    }
+
+    if (!is_valid || checker.remaining() != 0) {
+        if (report_errors) {
+            *this->error_stream << "Snapshot error: snapshot is truncated or corrupted.\n";
+        }
+
+        return false;
+    }
+
+    this->present_arguments.reset(this->arguments.size());
+    this->validation_results.clear();
+    this->deferred_argument = nullptr;
+    this->positional_ranges.clear();
+
+    for (size_t i = 0; i < this->arguments.size(); i++) {
+        uint8_t is_present = 0;
+        reader.read(is_present);
+        this->arguments[i]->restore_state(reader);
+
+        if (is_present) {
+            this->present_arguments.set(i);
+        }
+    }
+
+    return true;
+}
+
+bool ArgParser::save_snapshot(std::vector<std::byte>& snapshot) {
+    return this->write_snapshot(snapshot, true);
+}
+
+bool ArgParser::restore_snapshot(std::span<const std::byte> snapshot) {
+    return this->read_snapshot(snapshot, true);
+}
+
+void ArgParser::enable_parse_cache(size_t capacity) {
+    if (capacity == 0) {
+        this->parse_cache.reset();
+        return;
+    }
+
+    this->parse_cache = std::make_unique<ParseCache>(capacity);
+}
+
+ParseCacheStats ArgParser::get_parse_cache_stats() {
+    if (this->parse_cache == nullptr) {
+        return {};
+    }
+
+    return this->parse_cache->get_stats();
+}
+
+void ArgParser::set_allow_abbreviations(bool allow_abbreviations) {
+    this->allow_abbreviations = allow_abbreviations;
+
+    if (this->parse_cache != nullptr) {
+        this->parse_cache->clear();
+    }
+}
+
+void ArgParser::set_concurrent_validation(bool is_concurrent) {
+    this->is_validation_concurrent = is_concurrent;
+}
+
+void ArgParser::set_validation_timeout(std::chrono::milliseconds timeout) {
+    this->validation_timeout = timeout;
+}
+
+const std::vector<ValidationResult>& ArgParser::get_validation_results() {
+    return this->validation_results;
+}
+
+void ArgParser::set_error_stream(std::ostream* stream) {
+    this->error_stream = stream;
+}
+
+std::ostream& ArgParser::get_error_stream() const {
+    return *this->error_stream;
+}
+
 void ArgParser::set_help_formatter(const AbstractHelpFormatter* formatter) {
     this->description_formatter = formatter;
 }
@@ -327,7 +1295,7 @@ bool ArgParser::help() {
 }
 
 std::string ArgParser::get_help_description() {
-    return this->description_formatter->format(this->name, this->description, *this->arguments);
+    return this->description_formatter->format(this->name, this->description, this->arguments);
 }
 
 FlagArgument& ArgParser::add_flag(const char* argument_name, const char* description) {
@@ -377,5 +1345,25 @@ CREATE_ARGUMENT_FUNCTIONS(Int16Argument, int16_t, int16);
 CREATE_ARGUMENT_FUNCTIONS(UInt16Argument, uint16_t, uint16);
 CREATE_ARGUMENT_FUNCTIONS(Int32Argument, int32_t, int32);
 CREATE_ARGUMENT_FUNCTIONS(UInt32Argument, uint32_t, uint32);
+CREATE_ARGUMENT_FUNCTIONS(FileArgument, MappedFile, file);
+
+#define INSTANTIATE_ARGUMENT_TEMPLATES(argument_type, value_type) \
+template argument_type& ArgParser::add_argument<argument_type>(const char* argument_name, const char* description); \
+\
+template argument_type& ArgParser::add_argument<argument_type>(char short_argument_name, const char* argument_name, const char* description); \
+\
+template std::optional<value_type> ArgParser::get_argument_value<value_type>(const char* argument_name); \
+\
+template std::optional<value_type> ArgParser::get_argument_value<value_type>(const char* argument_name, size_t index);
+
+INSTANTIATE_ARGUMENT_TEMPLATES(StringArgument, std::string);
+INSTANTIATE_ARGUMENT_TEMPLATES(IntArgument, int);
+INSTANTIATE_ARGUMENT_TEMPLATES(Int8Argument, int8_t);
+INSTANTIATE_ARGUMENT_TEMPLATES(UInt8Argument, uint8_t);
+INSTANTIATE_ARGUMENT_TEMPLATES(Int16Argument, int16_t);
+INSTANTIATE_ARGUMENT_TEMPLATES(UInt16Argument, uint16_t);
+INSTANTIATE_ARGUMENT_TEMPLATES(UInt32Argument, uint32_t);
+INSTANTIATE_ARGUMENT_TEMPLATES(FlagArgument, bool);
+INSTANTIATE_ARGUMENT_TEMPLATES(FileArgument, MappedFile);
 
 }
\ No newline at end of file
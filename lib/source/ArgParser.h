@@ -1,72 +1,363 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <chrono>
+#include <unordered_map>
+#include <memory>
+#include <iosfwd>
+#include <span>
 #include <string_view>
 #include <cstdint>
 
 #include "argument.h"
+#include "choice_argument.h"
+#include "field_binding.h"
+#include "file_argument.h"
 #include "help_formatter.h"
+#include "generator.h"
+#include "name_trie.h"
+#include "argument_mask.h"
+#include "parse_cache.h"
+#include "small_vector.h"
+#include "token_list.h"
 
 namespace ArgumentParser {
 
-const static AbstractHelpFormatter* DEFAULT_FORMATTER = new DefaultHelpFormatter();
+struct ValidationThread;
+
+// Outcome of one argument's validator in the last parse.
+struct ValidationResult {
+    const char* argument_name = nullptr;
+    bool is_valid = true;
+    bool is_timed_out = false;
+    std::string error;
+    std::chrono::nanoseconds duration = std::chrono::nanoseconds(0);
+};
+
+// Candidates for the token at the cursor of a partial command line, see ArgParser::complete.
+struct CompletionResult {
+    // Option spellings that complete the token, e.g. "--output" and "-o", for options that may still be given.
+    std::vector<std::string> options;
+    // Argument that takes the token as its value, null if none does.
+    // Its name and description serve as a hint for free-form values.
+    ArgumentBase* value_argument = nullptr;
+    // Accepted values of value_argument that start with the typed part of the token.
+    std::vector<std::string_view> values;
+};
 
 class ArgParser {
 private:
     const char* name = nullptr;
     const char* description = nullptr;
 
-    const AbstractHelpFormatter* description_formatter = DEFAULT_FORMATTER;
+    // Not owned, see set_help_formatter.
+    const AbstractHelpFormatter* description_formatter = &default_help_formatter();
 
-    std::vector<ArgumentBase*>* arguments = nullptr;
+    std::vector<std::unique_ptr<ArgumentBase>> arguments;
     bool may_next_argument_be_free = false;
 
+    // Not owned, see set_error_stream. Set to std::cerr by the constructor.
+    std::ostream* error_stream = nullptr;
+
+    // Unique-prefix lookup of long names, rebuilt on first use after the arguments change.
+    bool allow_abbreviations = false;
+    bool is_name_trie_built = false;
+    NameTrie name_trie;
+
     FlagArgument* help_argument = nullptr;
 
-    bool parse_positional_arguments(std::vector<std::string_view>& arguments);
+    struct ArgumentConstraint {
+        enum class Kind {
+            MutuallyExclusive,
+            Requires,
+            AtLeastOneOf,
+        };
+
+        Kind kind;
+        // For Requires: the arguments that need the others.
+        std::vector<const char*> trigger_names;
+        std::vector<const char*> argument_names;
+
+        std::vector<MaskWord> trigger_mask;
+        std::vector<MaskWord> mask;
+
+        ArgumentConstraint(Kind kind, std::vector<const char*> trigger_names, std::vector<const char*> argument_names)
+            : kind(kind), trigger_names(std::move(trigger_names)), argument_names(std::move(argument_names)) {}
+    };
+
+    // Constraints are compiled into masks over argument indices on first use after a change.
+    std::vector<ArgumentConstraint> constraints;
+    bool are_constraints_compiled = false;
+
+    // Schema layout computed by freeze, recomputed on the first parse after the arguments change.
+    bool is_frozen = false;
+    // Indices of the positional arguments in declaration order. The first one without a maximum
+    // token count, if any, is at variadic_position.
+    std::vector<size_t> positional_indices;
+    size_t variadic_position = 0;
+    bool has_variadic_positional = false;
+    // Sum of the minimum token counts from every position to the last, one more entry than
+    // positional_indices, and the token counts of the last parse.
+    std::vector<size_t> positional_min_suffix;
+    std::vector<size_t> positional_counts;
+    // Single-value arguments that need a value and have no default.
+    std::vector<MaskWord> required_mask;
+    // Multi-value arguments with a minimum value count.
+    std::vector<size_t> min_count_indices;
+    // Name lookups of the parse loop, so that a token costs O(its length) whatever the number of arguments.
+    std::unordered_map<std::string_view, size_t> long_name_indices;
+    std::array<ArgumentBase*, 256> short_name_arguments = {};
+
+    // See set_concurrent_validation and set_validation_timeout.
+    bool is_validation_concurrent = false;
+    std::chrono::milliseconds validation_timeout = std::chrono::milliseconds(0);
+    // In declaration order of the validated arguments.
+    std::vector<ValidationResult> validation_results;
+    // Threads of concurrent validators, joined once their validator is done, at the latest by the
+    // destructor. Those that outlive their parse because of the timeout stay here until then.
+    std::vector<std::unique_ptr<ValidationThread>> validation_threads;
+
+    // Arguments given on the command line during the last parse.
+    ArgumentMask present_arguments;
+
+    // Set during parse_incremental: arguments whose values were copied from the previous parser
+    // are neither cleared nor converted again, and keep the presence they had there.
+    bool is_reusing_values = false;
+    ArgumentMask reused_arguments;
+    ArgumentMask reused_present_arguments;
+
+    // Snapshots of earlier successful parses, see enable_parse_cache.
+    std::unique_ptr<ParseCache> parse_cache;
+
+    // Computed on first use after the arguments change.
+    uint64_t schema_hash = 0;
+    bool is_schema_hash_computed = false;
+
+    // Tokens of the last parse and the runs of positional tokens among them.
+    // The ranges are reused across parses, so positionals are never copied out of argv.
+    TokenList parsed_tokens;
+    // Null-terminated copies of string_view tokens, which converters read as C strings.
+    // Reused across parses.
+    std::string owned_token_bytes;
+    std::vector<std::string_view> owned_tokens;
+    SmallVector<TokenRange, 8> positional_ranges;
+
+    // Set by parse_lazy: the variadic positional is not converted, lazy_values reads its tokens
+    // from parsed_tokens. The bounds are ordinals among the positional tokens.
+    bool defer_multi_value_argument = false;
+    ArgumentBase* deferred_argument = nullptr;
+    size_t deferred_begin = 0;
+    size_t deferred_end = 0;
+
+    void add_positional_token(size_t index);
+
+    bool parse_positional_arguments();
 
     bool parse_argument(const std::string_view& arg, const std::string_view& next_arg);
 
     bool parse_short_argument(const std::string_view& arg, const std::string_view& next_arg);
 
-    bool handle_argument_value(ArgumentBase* argument, const std::string_view& arg, const std::string_view& next_arg);
+    // attached_value is the part of the token after '=', or null if the token has none.
+    bool handle_argument_value(ArgumentBase* argument, const char* attached_value, const std::string_view& next_arg);
+
+    void register_argument(std::unique_ptr<ArgumentBase> argument);
+
+    // Records the parse in the capture log when ARGPARSER_CAPTURE is set.
+    bool parse_token_list(const TokenList& args);
+
+    // Copies args into owned_token_bytes and returns null-terminated views of the copies.
+    std::span<const std::string_view> copy_tokens(std::span<const std::string_view> args);
+
+    bool parse_cached(const TokenList& args);
+
+    bool parse_tokens(const TokenList& args);
+
+    bool parse_lazy_tokens(const TokenList& args);
+
+    bool parse_argument_value(ArgumentBase* argument, const char* value);
+
+    bool write_snapshot(std::vector<std::byte>& snapshot, bool report_errors);
+
+    bool read_snapshot(std::span<const std::byte> snapshot, bool report_errors);
 
     bool validate_arguments();
 
+    bool compile_constraints();
+
+    bool validate_constraints();
+
+    bool run_validators();
+
     ArgumentBase* find_argument_by_name(const char* argument_name);
 
-    ArgumentBase* find_argument_by_full_name(const char* argument_name);
+    // argument_name may be followed by '=' and the value.
+    ArgumentBase* find_argument_by_full_name(std::string_view argument_name);
 
     ArgumentBase* find_argument_by_short_name(const char argument_name);
+
+    // Built on first use after the arguments change.
+    const NameTrie& get_name_trie();
+
+    CompletionResult complete_tokens(const TokenList& args, size_t cursor_index);
 public:
     ArgParser(const char* name);
 
+    ArgParser(const ArgParser&) = delete;
+
+    ArgParser& operator=(const ArgParser&) = delete;
+
+    // Joins the threads of concurrent validators.
     ~ArgParser();
 
+    // Validates the schema and precomputes the positional layout and the required-argument mask.
+    // Up to the first unbounded positional, each positional takes as many tokens as it can while
+    // leaving the minimum of the ones after it. The positionals after it are filled from the last
+    // one backwards in the same way, and the first unbounded one takes the rest, so for
+    // SRC... DST [EXTRA{0,3}] EXTRA gets up to three tokens, and of several unbounded positionals
+    // the last one takes every token the others leave beyond their minimum. A parse splits the
+    // tokens in O(positionals).
+    // Called by the first parse after the arguments change, or explicitly to report schema
+    // errors before parsing. Configure all arguments before freezing.
+    bool freeze();
+
+    // When the ARGPARSER_CAPTURE environment variable names a file, every parse appends its tokens
+    // and latency to that file, see CaptureLog and bin/replay.cpp.
+    //
+    // Parsing runs in O(total token bytes + number of arguments), whatever the tokens are: every
+    // token is scanned a constant number of times and names are looked up in tables built by
+    // freeze. bench/adversarial_bench.cpp checks the bound on hostile input. Validators, custom
+    // converters and abbreviation errors, which list the candidates, are not covered.
     bool parse(int argc, const char** argv);
 
     bool parse(const std::vector<std::string>& args);
 
-    bool parse(const std::vector<std::string_view>& args);
+    // Parses the tokens in place, without copying them into intermediate containers.
+    bool parse(std::span<const char* const> args);
+
+    // The views need not be null-terminated, e.g. substrings of one buffer: they are copied into
+    // storage owned by the parser first, one O(total bytes) copy per parse.
+    bool parse(std::span<const std::string_view> args);
+
+    // Parses like parse, but leaves the variadic positional argument unconverted.
+    // Its values are then produced one by one by lazy_values.
+    bool parse_lazy(int argc, const char** argv);
+
+    bool parse_lazy(std::span<const char* const> args);
+
+    // Copies the views like parse does.
+    bool parse_lazy(std::span<const std::string_view> args);
+
+    // Converts each value of the variadic positional argument only when it is pulled.
+    // Yields std::nullopt for a value that fails to convert. The parser and the parsed
+    // argv must outlive the generator and must not be re-parsed while it is in use.
+    template <typename T, auto parse> Generator<std::optional<T>> lazy_values(Argument<T, parse>& argument) {
+        if (static_cast<ArgumentBase*>(&argument) != this->deferred_argument) {
+            co_return;
+        }
+
+        size_t ordinal = 0;
+        for (const TokenRange& range : this->positional_ranges) {
+            for (size_t i = range.begin; i < range.end; i++, ordinal++) {
+                if (ordinal >= this->deferred_begin && ordinal < this->deferred_end) {
+                    co_yield argument.convert(this->parsed_tokens[i].data(), *this->error_stream);
+                }
+            }
+        }
+    }
+
+    // Parses args like parse, but converts only the values of the arguments named in reparsed_names.
+    // Every other argument takes its values and presence from previous, a parser with the same
+    // schema whose last successful parse read the same tokens for it; args may leave those tokens
+    // out. changed_names receives the names of the arguments whose values differ from previous.
+    // Nothing is read from the parse cache. args are copied like parse does.
+    bool parse_incremental(std::span<const std::string_view> args, ArgParser& previous, std::span<const std::string_view> reparsed_names, std::vector<const char*>& changed_names);
+
+    // Completion for the token at cursor_index, which may be one past the last token to start a new one.
+    // The tokens before the cursor are read like parse does, without converting values, so that
+    // options already given, and those excluded by them, are not offered again. Never fails and
+    // never writes to the error stream; runs in O(total token bytes + number of arguments).
+    CompletionResult complete(std::span<const char* const> args, size_t cursor_index);
+
+    CompletionResult complete(const std::vector<std::string>& args, size_t cursor_index);
+
+    // Accept any unambiguous prefix of a long argument name, e.g. --verb for --verbose.
+    void set_allow_abbreviations(bool allow_abbreviations);
+
+    // At most one of the arguments may be given.
+    void add_mutually_exclusive_group(std::initializer_list<const char*> argument_names);
+
+    // If the argument is given, all of the required arguments must be given too.
+    void add_requirement(const char* argument_name, std::initializer_list<const char*> required_argument_names);
+
+    // At least one of the arguments must be given.
+    void add_at_least_one_of_group(std::initializer_list<const char*> argument_names);
+
+    // Runs the validators of all parsed arguments at the same time, each on its own thread owned
+    // by the parser. Errors are still reported in declaration order.
+    void set_concurrent_validation(bool is_concurrent);
+
+    // A validator that runs longer than timeout fails the parse; zero means no limit. In
+    // concurrent mode the parse does not wait for it: the validator finishes in the background
+    // on copies of the values, and the destructor of the parser waits for it, so it must not use
+    // state that is destroyed before the parser. Sequential validators run on the parsing thread
+    // and cannot be stopped, so one that overruns fails the parse once it returns.
+    void set_validation_timeout(std::chrono::milliseconds timeout);
+
+    // Validators run by the last parse, with their errors and run times.
+    const std::vector<ValidationResult>& get_validation_results();
+
+    // Hash of all argument names, kinds and value types. Snapshots only load into parsers with the same hash.
+    // The hash is cached until the next argument is added.
+    uint64_t get_schema_hash();
+
+    // Serializes the values and presence of every argument from the last parse into a
+    // position-independent blob; values a store_values vector kept from earlier parses are left out.
+    // Returns false if some argument has a value type that cannot be snapshotted.
+    bool save_snapshot(std::vector<std::byte>& snapshot);
+
+    // Loads a blob made by save_snapshot, e.g. directly from shared memory, instead of parsing.
+    // Like a parse, it appends to store_values vectors.
+    bool restore_snapshot(std::span<const std::byte> snapshot);
+
+    // Keeps the results of up to capacity distinct command lines and restores them instead
+    // of parsing again. Capacity 0 disables the cache. Parsers with argument types that cannot
+    // be snapshotted are never cached. Configure all arguments before enabling the cache.
+    void enable_parse_cache(size_t capacity);
+
+    ParseCacheStats get_parse_cache_stats();
 
     void add_help(char short_argument_name, const char* argument_name, const char* description = nullptr);
 
+    // The formatter is not owned by the parser and must outlive it.
     void set_help_formatter(const AbstractHelpFormatter* formatter);
 
+    // Parse and schema errors are written to stream instead of std::cerr.
+    // The stream is not owned by the parser and must outlive it.
+    void set_error_stream(std::ostream* stream);
+
+    std::ostream& get_error_stream() const;
+
+    // Exact or, with abbreviations allowed, unambiguous long name, null otherwise. Reports nothing.
+    // The parser must be frozen.
+    ArgumentBase* lookup_long_name(std::string_view name);
+
     bool help();
 
     std::string get_help_description();
 
     template <typename T> T& add_argument(const char* argument_name, const char* description) {
-        T* argument = new T(argument_name, description);
-        this->arguments->push_back(argument);
-        return *argument;
+        std::unique_ptr<T> argument = std::make_unique<T>(argument_name, description);
+        T& reference = *argument;
+        this->register_argument(std::move(argument));
+        return reference;
     }
 
     template <typename T> T& add_argument(char short_argument_name, const char* argument_name, const char* description) {
-        T* argument = new T(short_argument_name, argument_name, description);
-        this->arguments->push_back(argument);
-        return *argument;
+        std::unique_ptr<T> argument = std::make_unique<T>(short_argument_name, argument_name, description);
+        T& reference = *argument;
+        this->register_argument(std::move(argument));
+        return reference;
     }
 
     template <typename T> T& get_argument(const char* argument_name) {
@@ -103,6 +394,54 @@ public:
         return std::any_cast<T>(value);
     }
 
+    // Value of the argument behind a handle from argument.handle(): an index and a cast, no name
+    // lookup and no std::any. The handle must come from an argument of this parser.
+    template <typename T> const T& operator[](ArgumentHandle<T> handle) const {
+        return static_cast<const TypedArgument<T>*>(this->arguments[handle.index].get())->get_typed_value();
+    }
+
+    template <typename T> typename TypedArgument<T>::ValueReference get_value(ArgumentHandle<T> handle, size_t index) const {
+        return static_cast<const TypedArgument<T>*>(this->arguments[handle.index].get())->get_typed_value(index);
+    }
+
+    template <const auto& choices> ChoiceArgument<choices>& add_choice_argument(const char* argument_name, const char* description = nullptr) {
+        return this->add_argument<ChoiceArgument<choices>>(argument_name, description);
+    }
+
+    template <const auto& choices> ChoiceArgument<choices>& add_choice_argument(char short_argument_name, const char* argument_name, const char* description = nullptr) {
+        return this->add_argument<ChoiceArgument<choices>>(short_argument_name, argument_name, description);
+    }
+
+    // Registers an argument that parses straight into options.*binding.member, so the value is
+    // read from the struct without a name lookup. The initial value of a scalar field is its
+    // default; a std::vector field collects every value like store_values, so it keeps the
+    // values of earlier parses. options must outlive the parser.
+    template <typename Struct, typename T> FieldArgument<T>& bind_field(Struct& options, const FieldBinding<Struct, T>& binding) {
+        FieldArgument<T>* argument = nullptr;
+        if (binding.short_name != 0) {
+            argument = &this->add_argument<FieldArgument<T>>(binding.short_name, binding.name, binding.description);
+        } else {
+            argument = &this->add_argument<FieldArgument<T>>(binding.name, binding.description);
+        }
+
+        T& value = options.*binding.member;
+        if constexpr (FieldTraits<T>::is_multi_value) {
+            argument->mark_multi_value().store_values(value);
+        } else {
+            if constexpr (std::is_same_v<T, bool>) {
+                argument->set_should_have_argument(false);
+            }
+
+            argument->set_default_value(value).store_value(value);
+        }
+
+        return *argument;
+    }
+
+    template <typename Struct, typename... Fields> void bind_fields(Struct& options, const FieldBinding<Struct, Fields>&... bindings) {
+        (this->bind_field(options, bindings), ...);
+    }
+
     FlagArgument& add_flag(const char* argument_name, const char* description = nullptr);
 
     FlagArgument& add_flag(char short_argument_name, const char* argument_name, const char* description = nullptr);
@@ -126,6 +465,29 @@ public:
     CREATE_ARGUMENT_HEADER_FUNCTIONS(UInt16Argument, uint16_t, uint16);
     CREATE_ARGUMENT_HEADER_FUNCTIONS(Int32Argument, int32_t, int32);
     CREATE_ARGUMENT_HEADER_FUNCTIONS(UInt32Argument, uint32_t, uint32);
+    CREATE_ARGUMENT_HEADER_FUNCTIONS(FileArgument, MappedFile, file);
 };
 
+// Member templates for the built-in argument types are instantiated once in ArgParser.cpp.
+#define DECLARE_ARGUMENT_TEMPLATES(argument_type, value_type) \
+    extern template argument_type& ArgParser::add_argument<argument_type>(const char* argument_name, const char* description); \
+    \
+    extern template argument_type& ArgParser::add_argument<argument_type>(char short_argument_name, const char* argument_name, const char* description); \
+    \
+    extern template std::optional<value_type> ArgParser::get_argument_value<value_type>(const char* argument_name); \
+    \
+    extern template std::optional<value_type> ArgParser::get_argument_value<value_type>(const char* argument_name, size_t index);
+
+DECLARE_ARGUMENT_TEMPLATES(StringArgument, std::string);
+DECLARE_ARGUMENT_TEMPLATES(IntArgument, int);
+DECLARE_ARGUMENT_TEMPLATES(Int8Argument, int8_t);
+DECLARE_ARGUMENT_TEMPLATES(UInt8Argument, uint8_t);
+DECLARE_ARGUMENT_TEMPLATES(Int16Argument, int16_t);
+DECLARE_ARGUMENT_TEMPLATES(UInt16Argument, uint16_t);
+DECLARE_ARGUMENT_TEMPLATES(UInt32Argument, uint32_t);
+DECLARE_ARGUMENT_TEMPLATES(FlagArgument, bool);
+DECLARE_ARGUMENT_TEMPLATES(FileArgument, MappedFile);
+
+#undef DECLARE_ARGUMENT_TEMPLATES
+
 } // namespace ArgumentParser
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "argument.h"
 
+#include <cstdlib>
+#include <iostream>
+
 namespace ArgumentParser {
 
 ArgumentBase::ArgumentBase(const char* name, const char* description) {
@@ -13,6 +16,12 @@ ArgumentBase::ArgumentBase(const char short_name, const char* name, const char*
     this->description = description;
 }
 
+void ArgumentBase::fail_without_value() const {
+    std::cerr << "Argument error: argument has neither a parsed nor a default value. Argument name: "
+        << (this->name != nullptr ? this->name : std::string(1, this->short_name)) << '\n';
+    std::abort();
+}
+
 const char* ArgumentBase::get_name() {
     return this->name;
 }
@@ -25,7 +34,31 @@ const char* ArgumentBase::get_description() {
     return this->description;
 }
 
-std::optional<std::string> parse_string(const char* string_value, std::optional<std::string> default_value) {
+size_t ArgumentBase::get_index() {
+    return this->index;
+}
+
+void ArgumentBase::set_index(size_t index) {
+    this->index = index;
+}
+
+uint64_t ArgumentBase::get_schema_hash() {
+    uint64_t hash = hash_string(this->name != nullptr ? this->name : "");
+    hash = hash_string(std::string_view(&this->short_name, 1), hash);
+
+    char kind[] = {this->should_have_argument(), this->is_positional(), this->is_multi_value()};
+    return hash_string(std::string_view(kind, sizeof(kind)), hash);
+}
+
+std::vector<std::string_view> ArgumentBase::get_choices() {
+    return {};
+}
+
+std::function<bool(std::string& error)> ArgumentBase::make_validation_task() {
+    return nullptr;
+}
+
+std::optional<std::string> parse_string(const char* string_value, const std::optional<std::string>& default_value) {
     if (string_value == nullptr) {
         return std::nullopt;
     }
@@ -33,7 +66,7 @@ std::optional<std::string> parse_string(const char* string_value, std::optional<
     return std::string(string_value);
 }
 
-std::optional<bool> parse_flag(const char* string_value, std::optional<bool> default_value) {
+std::optional<bool> parse_flag(const char* string_value, const std::optional<bool>& default_value) {
     if (default_value.has_value()) {
         return !default_value.value();
     }
@@ -41,4 +74,20 @@ std::optional<bool> parse_flag(const char* string_value, std::optional<bool> def
     return std::nullopt;
 }
 
+template std::optional<int> parse_from_chars<int>(const char*, const std::optional<int>&);
+template std::optional<int8_t> parse_from_chars<int8_t>(const char*, const std::optional<int8_t>&);
+template std::optional<uint8_t> parse_from_chars<uint8_t>(const char*, const std::optional<uint8_t>&);
+template std::optional<int16_t> parse_from_chars<int16_t>(const char*, const std::optional<int16_t>&);
+template std::optional<uint16_t> parse_from_chars<uint16_t>(const char*, const std::optional<uint16_t>&);
+template std::optional<uint32_t> parse_from_chars<uint32_t>(const char*, const std::optional<uint32_t>&);
+
+template class Argument<int, parse_from_chars<int>>;
+template class Argument<int8_t, parse_from_chars<int8_t>>;
+template class Argument<uint8_t, parse_from_chars<uint8_t>>;
+template class Argument<int16_t, parse_from_chars<int16_t>>;
+template class Argument<uint16_t, parse_from_chars<uint16_t>>;
+template class Argument<uint32_t, parse_from_chars<uint32_t>>;
+template class Argument<std::string, parse_string>;
+template class Argument<bool, parse_flag>;
+
 } // namespace ArgumentParser
@@ -1,13 +1,25 @@
 #pragma once
 
-#include <iostream>
+#include <string>
 #include <vector>
+#include <string_view>
 #include <optional>
 #include <charconv>
 #include <any>
 #include <cstring>
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <utility>
+#include <typeinfo>
+#include <limits>
+#include <ostream>
+#include <type_traits>
 
 #include "string_utils.h"
+#include "small_vector.h"
+#include "snapshot.h"
+#include "delimited_values.h"
 
 namespace ArgumentParser {
 
@@ -16,6 +28,12 @@ private:
     char short_name = 0;
     const char* name = nullptr;
     const char* description = nullptr;
+
+    // Position of the argument in its parser.
+    size_t index = 0;
+protected:
+    // Reports a read of an argument without a parsed or default value and aborts.
+    [[noreturn]] void fail_without_value() const;
 public:
     ArgumentBase(const char* name, const char* description = nullptr);
 
@@ -23,7 +41,11 @@ public:
 
     virtual ~ArgumentBase() = default;
     
-    virtual bool parse_value(const char* string_value) = 0;
+    // Converters that explain their failures, e.g. by listing the valid choices, write to errors.
+    virtual bool parse_value(const char* string_value, std::ostream& errors) = 0;
+
+    // Whether parse_value writes its own message when a value fails to convert.
+    virtual bool reports_conversion_errors() = 0;
 
     virtual std::any get_value() = 0;
 
@@ -41,79 +63,249 @@ public:
 
     virtual size_t get_min_value_count() = 0;
 
+    // Most tokens a positional argument takes, SIZE_MAX if unbounded.
+    virtual size_t get_max_value_count() = 0;
+
     virtual size_t get_value_count() = 0;
 
+    // Values added since the last clear_values, without those a store_values vector kept from
+    // earlier parses.
+    virtual size_t get_parsed_value_count() = 0;
+
+    // Makes room for count more values, growing the storage at least geometrically.
+    virtual void reserve_values(size_t count) = 0;
+
+    // Names of the accepted values, empty if the argument takes any value.
+    virtual std::vector<std::string_view> get_choices();
+
+    // Forgets all parsed values; defaults and store_value targets are kept. The store_values
+    // vector is only emptied with is_clearing_stored_values, otherwise the next values are
+    // appended after the ones it holds.
+    virtual void clear_values(bool is_clearing_stored_values) = 0;
+
+    // Hash of the argument's names, kind and value type.
+    virtual uint64_t get_schema_hash();
+
+    // Appends the values of the last parse to a snapshot. Returns false if the value type cannot be snapshotted.
+    virtual bool save_state(SnapshotWriter& writer) = 0;
+
+    // Replaces the parsed values with the ones read from a snapshot, appending to a store_values
+    // vector like a parse does.
+    virtual bool restore_state(SnapshotReader& reader) = 0;
+
+    // Reads past the state written by save_state without changing the argument.
+    // Returns false if the state is truncated or corrupted.
+    virtual bool skip_state(SnapshotReader& reader) = 0;
+
+    // Replaces the parsed values with copies of the ones of other, an argument of the same type.
+    virtual void copy_state(ArgumentBase& other) = 0;
+
+    // Runs the validator over copies of the parsed values, so it can run on another thread
+    // while the argument is reused. Empty if there is no validator or no parsed value.
+    virtual std::function<bool(std::string& error)> make_validation_task();
+
     const char* get_name();
 
     const char get_short_name();
 
     const char* get_description();
+
+    size_t get_index();
+
+    void set_index(size_t index);
 };
 
 template<typename T>
-using ParserFunction = std::optional<T> (*)(const char*, std::optional<T> default_value);
+using ParserFunction = std::optional<T> (*)(const char*, const std::optional<T>& default_value);
+
+// A converter is either a ParserFunction or a stateless callable (e.g. a captureless lambda)
+// with the same signature. Callables are invoked directly, so they can be inlined. A converter
+// that explains its failures takes the parser's error stream as a third argument.
+template <typename Parser, typename T>
+concept ReportingValueParser = requires(const Parser& parser, const char* string_value, const std::optional<T>& default_value, std::ostream& errors) {
+    { parser(string_value, default_value, errors) } -> std::convertible_to<std::optional<T>>;
+};
+
+template <typename Parser, typename T>
+concept ValueParser = ReportingValueParser<Parser, T> || requires(const Parser& parser, const char* string_value, const std::optional<T>& default_value) {
+    { parser(string_value, default_value) } -> std::convertible_to<std::optional<T>>;
+};
+
+template <typename T>
+std::optional<T> parse_from_chars(const char* string_value, const std::optional<T>& default_value);
+
+// Typed reference to an argument of a parser: its index, with the value type known at compile time.
+// Read through ArgParser::operator[] of the parser that created it.
+template <typename T> struct ArgumentHandle {
+    size_t index = 0;
+};
+
+// Value storage shared by all arguments with values of type T, whatever their converter.
+template <typename T> class TypedArgument : public ArgumentBase {
+protected:
+    static constexpr size_t INLINE_VALUE_COUNT = 8;
 
-template <typename T, ParserFunction<T> parse> class Argument : public ArgumentBase {
-private:
     std::optional<T> default_value = std::nullopt;
 
+    // The argument owns its storage; value and values only point to variables provided
+    // by the user through store_value and store_values.
+    std::optional<T> owned_value = std::nullopt;
     T* value = nullptr;
+    SmallVector<T, INLINE_VALUE_COUNT> inline_values;
     std::vector<T>* values = nullptr;
+    // Values of a store_values vector kept from earlier parses; the last parse added the rest.
+    size_t first_parsed_value = 0;
 
-    bool owned = true;
     bool _has_value = false;
+public:
+    // std::vector<bool> has no bool elements to refer to, so bool values are returned by value.
+    using ValueReference = std::conditional_t<std::is_same_v<T, bool>, bool, const T&>;
+
+    using ArgumentBase::ArgumentBase;
+
+    ArgumentHandle<T> handle() {
+        return {this->get_index()};
+    }
+
+    // The parsed value, or the default. Aborts if the argument has neither.
+    const T& get_typed_value() const {
+        if (this->value != nullptr) {
+            return *this->value;
+        }
+
+        if (this->owned_value.has_value()) {
+            return *this->owned_value;
+        }
+
+        if (!this->default_value.has_value()) {
+            this->fail_without_value();
+        }
+
+        return *this->default_value;
+    }
+
+    ValueReference get_typed_value(size_t index) const {
+        if (this->values != nullptr) {
+            return (*this->values)[index];
+        }
 
+        return this->inline_values[index];
+    }
+};
+
+template <typename T, auto parse> requires ValueParser<decltype(parse), T> class Argument : public TypedArgument<T> {
+private:
     bool _should_have_argument = true;
     bool _is_positional = false;
 
     bool _is_multi_value = false;
     size_t min_argument_count = 0;
+    size_t max_argument_count = std::numeric_limits<size_t>::max();
+    size_t expected_argument_count = 0;
+    // Splits every token of a multi-value argument into several values, zero if not set.
+    char delimiter = '\0';
 
-    bool set_value(T value) {
-        if (this->_has_value) {
-            return false;
-        }
-        
-        if (this->value == nullptr) {
-            this->value = new T;
+    std::function<bool(const T& value, std::string& error)> validator;
+
+    bool set_value(T&& value) {
+        if (this->value != nullptr) {
+            *this->value = std::move(value);
+        } else {
+            this->owned_value = std::move(value);
         }
         
-        *this->value = value;
         this->_has_value = true;
         return true;
     }
 
-    bool add_value(T value) {
-        if (this->values == nullptr) {
-            this->values = new std::vector<T>();
+    bool add_value(T&& value) {
+        if (this->get_value_count() == 0 && this->expected_argument_count > 0) {
+            this->reserve_values(this->expected_argument_count);
         }
-        
-        this->values->push_back(value);
+
+        if (this->values != nullptr) {
+            this->values->emplace_back(std::move(value));
+        } else {
+            this->inline_values.emplace_back(std::move(value));
+        }
+
         return true;
     }
 public:
-    Argument(const char* name, const char* description = nullptr) : ArgumentBase(name, description) {}
+    Argument(const char* name, const char* description = nullptr) : TypedArgument<T>(name, description) {}
 
-    Argument(const char short_name, const char* name, const char* description = nullptr) : ArgumentBase(short_name, name, description) {}
+    Argument(const char short_name, const char* name, const char* description = nullptr) : TypedArgument<T>(short_name, name, description) {}
 
-    ~Argument() override {
-        if (this->owned) {
-            delete this->value;
-            delete this->values;
+    std::optional<T> convert(const char* string_value, std::ostream& errors) const {
+        if constexpr (ReportingValueParser<decltype(parse), T>) {
+            return parse(string_value, this->default_value, errors);
+        } else {
+            return parse(string_value, this->default_value);
         }
     }
-    
-    bool parse_value(const char* string_value) override {
-        std::optional<T> optional_value = parse(string_value, this->default_value);
+
+    static constexpr bool is_parsed_from_chars() {
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> && std::is_same_v<decltype(parse), ParserFunction<T>>) {
+            return parse == parse_from_chars<T>;
+        } else {
+            return false;
+        }
+    }
+
+    bool parse_delimited_values(std::string_view token, std::ostream& errors) {
+        this->reserve_values(count_pieces(token, this->delimiter));
+
+        if constexpr (is_parsed_from_chars()) {
+            // Converted straight from the token, 8 digits at a time, into the reserved storage.
+            auto add_piece = [](auto& storage, std::string_view piece) {
+                std::optional<T> optional_value = parse_decimal<T>(piece);
+                if (!optional_value.has_value()) {
+                    return false;
+                }
+
+                storage.push_back(*optional_value);
+                return true;
+            };
+
+            if (this->values != nullptr) {
+                return for_each_piece(token, this->delimiter, [this, &add_piece](std::string_view piece) {
+                    return add_piece(*this->values, piece);
+                });
+            }
+
+            return for_each_piece(token, this->delimiter, [this, &add_piece](std::string_view piece) {
+                return add_piece(this->inline_values, piece);
+            });
+        } else {
+            // Converters take null-terminated strings, so each piece is copied into one reused buffer.
+            std::string piece_buffer;
+            return for_each_piece(token, this->delimiter, [this, &piece_buffer, &errors](std::string_view piece) {
+                piece_buffer.assign(piece);
+                std::optional<T> optional_value = this->convert(piece_buffer.c_str(), errors);
+                return optional_value.has_value() && this->add_value(std::move(*optional_value));
+            });
+        }
+    }
+
+    bool parse_value(const char* string_value, std::ostream& errors) override {
+        if (this->_is_multi_value && this->delimiter != '\0' && string_value != nullptr) {
+            return this->parse_delimited_values(string_value, errors);
+        }
+
+        std::optional<T> optional_value = this->convert(string_value, errors);
         if (!optional_value.has_value()) {
             return false;
         }
         
         if (this->_is_multi_value) {
-            return add_value(optional_value.value());
+            return add_value(std::move(*optional_value));
         }
 
-        return set_value(optional_value.value());
+        return set_value(std::move(*optional_value));
+    }
+
+    bool reports_conversion_errors() override {
+        return ReportingValueParser<decltype(parse), T>;
     }
 
     bool should_have_argument() override {
@@ -140,12 +332,184 @@ public:
         return this->min_argument_count;
     }
 
+    size_t get_max_value_count() override {
+        return this->max_argument_count;
+    }
+
+    void clear_values(bool is_clearing_stored_values) override {
+        this->_has_value = false;
+        this->owned_value.reset();
+        this->inline_values.clear();
+
+        // A stored variable must not keep the value of an earlier parse.
+        if (this->value != nullptr && this->default_value.has_value()) {
+            *this->value = *this->default_value;
+        }
+
+        if (this->values != nullptr && is_clearing_stored_values) {
+            this->values->clear();
+        }
+
+        this->first_parsed_value = this->values != nullptr ? this->values->size() : 0;
+    }
+
+    uint64_t get_schema_hash() override {
+        return hash_string(typeid(T).name(), ArgumentBase::get_schema_hash());
+    }
+
+    bool save_state(SnapshotWriter& writer) override {
+        if constexpr (!ValueCodec<T>::is_supported) {
+            return false;
+        } else {
+            writer.write<uint8_t>(this->_has_value);
+            if (this->_has_value) {
+                ValueCodec<T>::write(writer, this->value != nullptr ? *this->value : *this->owned_value);
+            }
+
+            writer.write<uint64_t>(this->get_parsed_value_count());
+
+            for (size_t i = this->first_parsed_value; i < this->get_value_count(); i++) {
+                ValueCodec<T>::write(writer, this->values != nullptr ? (*this->values)[i] : this->inline_values[i]);
+            }
+
+            return true;
+        }
+    }
+
+    bool restore_state(SnapshotReader& reader) override {
+        if constexpr (!ValueCodec<T>::is_supported) {
+            return false;
+        } else {
+            this->clear_values(false);
+
+            uint8_t has_value = 0;
+            if (!reader.read(has_value)) {
+                return false;
+            }
+
+            if (has_value) {
+                std::optional<T> restored_value = ValueCodec<T>::read(reader);
+                if (!restored_value.has_value()) {
+                    return false;
+                }
+
+                this->set_value(std::move(*restored_value));
+            }
+
+            uint64_t value_count = 0;
+            if (!reader.read(value_count) || value_count > reader.remaining() / ValueCodec<T>::min_size()) {
+                return false;
+            }
+
+            this->reserve_values(value_count);
+
+            for (size_t i = 0; i < value_count; i++) {
+                std::optional<T> restored_value = ValueCodec<T>::read(reader);
+                if (!restored_value.has_value()) {
+                    return false;
+                }
+
+                this->add_value(std::move(*restored_value));
+            }
+
+            return true;
+        }
+    }
+
+    bool skip_state(SnapshotReader& reader) override {
+        if constexpr (!ValueCodec<T>::is_supported) {
+            return false;
+        } else {
+            uint8_t has_value = 0;
+            if (!reader.read(has_value) || has_value > 1 || (has_value && !ValueCodec<T>::skip(reader))) {
+                return false;
+            }
+
+            uint64_t value_count = 0;
+            if (!reader.read(value_count) || value_count > reader.remaining() / ValueCodec<T>::min_size()) {
+                return false;
+            }
+
+            for (size_t i = 0; i < value_count; i++) {
+                if (!ValueCodec<T>::skip(reader)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    void copy_state(ArgumentBase& other) override {
+        Argument& source = static_cast<Argument&>(other);
+        this->clear_values(true);
+
+        if (source._has_value) {
+            this->set_value(T(source.get_typed_value()));
+        }
+
+        this->reserve_values(source.get_parsed_value_count());
+
+        for (size_t i = source.first_parsed_value; i < source.get_value_count(); i++) {
+            this->add_value(T(source.get_typed_value(i)));
+        }
+    }
+
+    std::function<bool(std::string& error)> make_validation_task() override {
+        if (!this->validator) {
+            return nullptr;
+        }
+
+        std::vector<T> parsed_values;
+        if (this->_has_value) {
+            parsed_values.push_back(this->value != nullptr ? *this->value : *this->owned_value);
+        }
+
+        for (size_t i = this->first_parsed_value; i < this->get_value_count(); i++) {
+            parsed_values.push_back(this->values != nullptr ? (*this->values)[i] : this->inline_values[i]);
+        }
+
+        if (parsed_values.empty()) {
+            return nullptr;
+        }
+
+        return [validator = this->validator, parsed_values = std::move(parsed_values)](std::string& error) {
+            for (const T& parsed_value : parsed_values) {
+                if (!validator(parsed_value, error)) {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+    }
+
     size_t get_value_count() override {
-        if (this->values == nullptr) {
-            return 0;
+        if (this->values != nullptr) {
+            return this->values->size();
+        }
+
+        return this->inline_values.size();
+    }
+
+    size_t get_parsed_value_count() override {
+        return this->get_value_count() - this->first_parsed_value;
+    }
+
+    void reserve_values(size_t count) override {
+        // Called once per token by delimited values, so capacity grows at least geometrically;
+        // reserving exactly size + count would copy all earlier values on every token.
+        auto reserve = [count](auto& storage) {
+            if (storage.capacity() < storage.size() + count) {
+                storage.reserve(std::max(storage.size() + count, storage.capacity() * 2));
+            }
+        };
+
+        if (this->values != nullptr) {
+            reserve(*this->values);
+        } else {
+            reserve(this->inline_values);
         }
-        
-        return this->values->size();
     }
 
     Argument& set_should_have_argument(bool value) {
@@ -154,19 +518,26 @@ public:
     }
 
     Argument& set_default_value(T value) {
-        this->default_value = value;
+        this->default_value = std::move(value);
+        return *this;
+    }
+
+    // Called after a successful parse with every parsed value, default values excluded.
+    // Returns false and sets error to reject a value.
+    Argument& set_validator(std::function<bool(const T& value, std::string& error)> validator) {
+        this->validator = std::move(validator);
         return *this;
     }
 
     Argument& store_value(T& value) {
         this->value = &value;
-        this->owned = false;
         return *this;
     }
 
+    // Every parse appends to values, so a vector reused across parses keeps the values of the
+    // earlier ones; a parse cache hit and restore_snapshot append the same way.
     Argument& store_values(std::vector<T>& values) {
         this->values = &values;
-        this->owned = false;
         return *this;
     }
 
@@ -175,6 +546,10 @@ public:
             return *this->value;
         }
 
+        if (this->owned_value.has_value()) {
+            return this->owned_value.value();
+        }
+
         if (this->default_value.has_value()) {
             return this->default_value.value();            
         }
@@ -183,7 +558,11 @@ public:
     }
 
     std::any get_value(size_t index) override {
-        return (*this->values)[index];
+        if (this->values != nullptr) {
+            return (*this->values)[index];
+        }
+
+        return this->inline_values[index];
     }
 
     T get_value_unsafe() {
@@ -191,9 +570,13 @@ public:
         return std::any_cast<T>(value);
     }
 
-    Argument& mark_multi_value(size_t min_argument_count = 0) {
+    // expected_argument_count is a capacity hint, reserved once before the first value is added.
+    // With a delimiter, every token is split into several values, e.g. --ids=1,2,3.
+    Argument& mark_multi_value(size_t min_argument_count = 0, size_t expected_argument_count = 0, char delimiter = '\0') {
         this->_is_multi_value = true;
         this->min_argument_count = min_argument_count;
+        this->expected_argument_count = std::max(min_argument_count, expected_argument_count);
+        this->delimiter = delimiter;
         return *this;
     }
 
@@ -202,10 +585,21 @@ public:
         this->_is_multi_value = true;
         return *this;
     }
+
+    // A positional taking between min_argument_count and max_argument_count tokens. (1, 1) is a
+    // single-value positional, read without an index. The positional tokens are split in
+    // declaration order, see ArgParser::freeze.
+    Argument& mask_positional(size_t min_argument_count, size_t max_argument_count = std::numeric_limits<size_t>::max()) {
+        this->mask_positional();
+        this->min_argument_count = min_argument_count;
+        this->max_argument_count = max_argument_count;
+        this->_is_multi_value = min_argument_count != 1 || max_argument_count != 1;
+        return *this;
+    }
 };
 
 template <typename T>
-std::optional<T> parse_from_chars(const char* string_value, std::optional<T> default_value) {
+std::optional<T> parse_from_chars(const char* string_value, const std::optional<T>& default_value) {
     T value;
 
     const char* begin = string_value;
@@ -225,9 +619,9 @@ std::optional<T> parse_from_chars(const char* string_value, std::optional<T> def
     return value;
 }
 
-std::optional<std::string> parse_string(const char* string_value, std::optional<std::string> default_value);
+std::optional<std::string> parse_string(const char* string_value, const std::optional<std::string>& default_value);
 
-std::optional<bool> parse_flag(const char* string_value, std::optional<bool> default_value);
+std::optional<bool> parse_flag(const char* string_value, const std::optional<bool>& default_value);
 
 typedef Argument<int, parse_from_chars<int>> IntArgument;
 typedef Argument<int8_t, parse_from_chars<int8_t>> Int8Argument;
@@ -239,4 +633,22 @@ typedef Argument<uint32_t, parse_from_chars<uint32_t>> UInt32Argument;
 typedef Argument<std::string, parse_string> StringArgument;
 typedef Argument<bool, parse_flag> FlagArgument;
 
+// Built-in argument types are instantiated once in argument.cpp.
+// Int32Argument is not listed since int32_t is int on all supported platforms.
+extern template std::optional<int> parse_from_chars<int>(const char*, const std::optional<int>&);
+extern template std::optional<int8_t> parse_from_chars<int8_t>(const char*, const std::optional<int8_t>&);
+extern template std::optional<uint8_t> parse_from_chars<uint8_t>(const char*, const std::optional<uint8_t>&);
+extern template std::optional<int16_t> parse_from_chars<int16_t>(const char*, const std::optional<int16_t>&);
+extern template std::optional<uint16_t> parse_from_chars<uint16_t>(const char*, const std::optional<uint16_t>&);
+extern template std::optional<uint32_t> parse_from_chars<uint32_t>(const char*, const std::optional<uint32_t>&);
+
+extern template class Argument<int, parse_from_chars<int>>;
+extern template class Argument<int8_t, parse_from_chars<int8_t>>;
+extern template class Argument<uint8_t, parse_from_chars<uint8_t>>;
+extern template class Argument<int16_t, parse_from_chars<int16_t>>;
+extern template class Argument<uint16_t, parse_from_chars<uint16_t>>;
+extern template class Argument<uint32_t, parse_from_chars<uint32_t>>;
+extern template class Argument<std::string, parse_string>;
+extern template class Argument<bool, parse_flag>;
+
 }
\ No newline at end of file
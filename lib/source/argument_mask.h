@@ -0,0 +1,78 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Non-zero 64-bit word of a mask over argument indices.
+struct MaskWord {
+    size_t index = 0;
+    uint64_t bits = 0;
+};
+
+// Bitset over argument indices.
+class ArgumentMask {
+private:
+    std::vector<uint64_t> words;
+public:
+    void reset(size_t bit_count) {
+        this->words.assign((bit_count + 63) / 64, 0);
+    }
+
+    void set(size_t index) {
+        if (index / 64 >= this->words.size()) {
+            this->words.resize(index / 64 + 1, 0);
+        }
+
+        this->words[index / 64] |= uint64_t(1) << (index % 64);
+    }
+
+    bool test(size_t index) const {
+        if (index / 64 >= this->words.size()) {
+            return false;
+        }
+
+        return (this->words[index / 64] >> (index % 64)) & 1;
+    }
+
+    // Number of bits set both in this mask and in the sparse mask.
+    size_t count_common(const std::vector<MaskWord>& mask) const {
+        size_t count = 0;
+        for (const MaskWord& word : mask) {
+            if (word.index < this->words.size()) {
+                count += std::popcount(this->words[word.index] & word.bits);
+            }
+        }
+
+        return count;
+    }
+
+    // Whether every bit of the sparse mask is set in this mask.
+    bool contains(const std::vector<MaskWord>& mask) const {
+        for (const MaskWord& word : mask) {
+            uint64_t bits = word.index < this->words.size() ? this->words[word.index] : 0;
+            if ((bits & word.bits) != word.bits) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Sparse copy holding only the non-zero words.
+    std::vector<MaskWord> to_sparse() const {
+        std::vector<MaskWord> mask;
+        for (size_t i = 0; i < this->words.size(); i++) {
+            if (this->words[i] != 0) {
+                mask.push_back({i, this->words[i]});
+            }
+        }
+
+        return mask;
+    }
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,325 @@
+#include "batch_parser.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ArgumentParser {
+
+namespace {
+
+// Chunk indices [begin, end) not yet taken from a worker. Both bounds are packed into one word,
+// so the owner takes chunks from the front and other workers steal from the back with a single
+// compare-and-swap.
+class alignas(64) ChunkQueue {
+private:
+    std::atomic<uint64_t> range = 0;
+
+    static uint64_t pack(uint64_t begin, uint64_t end) {
+        return (begin << 32) | end;
+    }
+public:
+    void assign(size_t begin, size_t end) {
+        this->range.store(pack(begin, end), std::memory_order_relaxed);
+    }
+
+    bool pop_front(size_t& chunk) {
+        uint64_t range = this->range.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t begin = range >> 32;
+            uint64_t end = range & UINT32_MAX;
+            if (begin == end) {
+                return false;
+            }
+
+            if (this->range.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_relaxed)) {
+                chunk = begin;
+                return true;
+            }
+        }
+    }
+
+    bool steal_back(size_t& chunk) {
+        uint64_t range = this->range.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t begin = range >> 32;
+            uint64_t end = range & UINT32_MAX;
+            if (begin == end) {
+                return false;
+            }
+
+            if (this->range.compare_exchange_weak(range, pack(begin, end - 1), std::memory_order_relaxed)) {
+                chunk = end - 1;
+                return true;
+            }
+        }
+    }
+};
+
+// Parse state owned by one worker and reused for every line it handles.
+struct Worker {
+    std::unique_ptr<ArgParser> parser;
+    std::string line;
+    std::vector<std::string_view> tokens;
+    std::ostringstream errors;
+    size_t error_count = 0;
+};
+
+bool is_space(char symbol) {
+    return symbol == ' ' || symbol == '\t' || symbol == '\r';
+}
+
+void append_errors(std::string& output, const std::string& errors) {
+    size_t length = output.size();
+
+    size_t begin = 0;
+    while (begin < errors.size()) {
+        size_t end = errors.find('\n', begin);
+        if (end == std::string::npos) {
+            end = errors.size();
+        }
+
+        if (end > begin) {
+            if (output.size() > length) {
+                output += "; ";
+            }
+
+            output.append(errors, begin, end - begin);
+        }
+
+        begin = end + 1;
+    }
+
+    if (output.size() == length) {
+        output += "invalid command line";
+    }
+}
+
+void parse_line(Worker& worker, const BatchParser::ResultFormatter& format_result, std::string_view line, std::string& output) {
+    // Tokens are split in place by overwriting separators with '\0', so every token stays null-terminated.
+    worker.line.assign(line);
+    worker.tokens.clear();
+
+    for (char& symbol : worker.line) {
+        if (is_space(symbol)) {
+            symbol = '\0';
+        }
+    }
+
+    size_t begin = 0;
+    while (begin < worker.line.size()) {
+        if (worker.line[begin] == '\0') {
+            begin++;
+            continue;
+        }
+
+        size_t end = begin;
+        while (end < worker.line.size() && worker.line[end] != '\0') {
+            end++;
+        }
+
+        worker.tokens.emplace_back(worker.line.data() + begin, end - begin);
+        begin = end;
+    }
+
+    if (worker.parser->parse(std::span<const std::string_view>(worker.tokens))) {
+        if (format_result) {
+            format_result(*worker.parser, output);
+        } else {
+            output += "ok";
+        }
+    } else {
+        worker.error_count++;
+        output += "error: ";
+        append_errors(output, worker.errors.str());
+    }
+
+    if (worker.errors.tellp() > 0) {
+        worker.errors.str("");
+    }
+
+    output += '\n';
+}
+
+} // namespace
+
+BatchParser::BatchParser(ParserFactory create_parser, ResultFormatter format_result) {
+    this->create_parser = std::move(create_parser);
+    this->format_result = std::move(format_result);
+    this->error_stream = &std::cerr;
+}
+
+void BatchParser::set_thread_count(size_t thread_count) {
+    this->thread_count = thread_count;
+}
+
+void BatchParser::set_chunk_size(size_t chunk_size) {
+    this->chunk_size = std::max<size_t>(chunk_size, 1);
+}
+
+void BatchParser::set_error_stream(std::ostream* stream) {
+    this->error_stream = stream;
+}
+
+void BatchParser::parse_lines(std::string_view input, std::string& output) {
+    output.clear();
+    this->parse_chunks(input, [&output](const std::string& chunk_output) {
+        output += chunk_output;
+    });
+}
+
+void BatchParser::parse_chunks(std::string_view input, const std::function<void(const std::string& chunk_output)>& write_chunk) {
+    std::vector<std::string_view> lines;
+
+    size_t begin = 0;
+    while (begin < input.size()) {
+        const void* newline = std::memchr(input.data() + begin, '\n', input.size() - begin);
+        size_t end = newline != nullptr ? static_cast<const char*>(newline) - input.data() : input.size();
+
+        lines.push_back(input.substr(begin, end - begin));
+        begin = end + 1;
+    }
+
+    size_t chunk_count = (lines.size() + this->chunk_size - 1) / this->chunk_size;
+
+    size_t thread_count = this->thread_count;
+    if (thread_count == 0) {
+        thread_count = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+    thread_count = std::max<size_t>(std::min(thread_count, chunk_count), 1);
+
+    // Every worker starts with an equal contiguous share of the chunks.
+    std::vector<ChunkQueue> queues(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        queues[i].assign(chunk_count * i / thread_count, chunk_count * (i + 1) / thread_count);
+    }
+
+    std::vector<Worker> workers(thread_count);
+    std::vector<std::string> chunk_outputs(chunk_count);
+
+    // Chunks before next_chunk are written; the others are written once every chunk before them is.
+    std::mutex write_mutex;
+    std::vector<uint8_t> is_chunk_parsed(chunk_count);
+    size_t next_chunk = 0;
+
+    auto run_worker = [&](size_t worker_index) {
+        Worker& worker = workers[worker_index];
+        worker.parser = this->create_parser();
+        worker.parser->set_error_stream(&worker.errors);
+
+        size_t chunk = 0;
+        while (true) {
+            bool has_chunk = queues[worker_index].pop_front(chunk);
+            for (size_t i = 1; !has_chunk && i < thread_count; i++) {
+                has_chunk = queues[(worker_index + i) % thread_count].steal_back(chunk);
+            }
+
+            if (!has_chunk) {
+                return;
+            }
+
+            size_t end = std::min((chunk + 1) * this->chunk_size, lines.size());
+            for (size_t i = chunk * this->chunk_size; i < end; i++) {
+                parse_line(worker, this->format_result, lines[i], chunk_outputs[chunk]);
+            }
+
+            std::lock_guard lock(write_mutex);
+            is_chunk_parsed[chunk] = true;
+            for (; next_chunk < chunk_count && is_chunk_parsed[next_chunk]; next_chunk++) {
+                write_chunk(chunk_outputs[next_chunk]);
+                std::string().swap(chunk_outputs[next_chunk]);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++) {
+        threads.emplace_back(run_worker, i);
+    }
+
+    run_worker(0);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    this->stats.line_count = lines.size();
+    this->stats.error_count = 0;
+    for (const Worker& worker : workers) {
+        this->stats.error_count += worker.error_count;
+    }
+}
+
+bool BatchParser::parse_file(const char* input_path, const char* output_path) {
+    int input_file = open(input_path, O_RDONLY);
+    if (input_file == -1) {
+        *this->error_stream << "Batch error: cannot open input file: " << input_path << '\n';
+        return false;
+    }
+
+    struct stat input_stat;
+    if (fstat(input_file, &input_stat) == -1) {
+        *this->error_stream << "Batch error: cannot read input file: " << input_path << '\n';
+        close(input_file);
+        return false;
+    }
+
+    size_t input_size = input_stat.st_size;
+    void* input = nullptr;
+    if (input_size > 0) {
+        input = mmap(nullptr, input_size, PROT_READ, MAP_PRIVATE, input_file, 0);
+        if (input == MAP_FAILED) {
+            *this->error_stream << "Batch error: cannot map input file: " << input_path << '\n';
+            close(input_file);
+            return false;
+        }
+
+        madvise(input, input_size, MADV_SEQUENTIAL);
+    }
+
+    close(input_file);
+
+    std::FILE* output_file = std::fopen(output_path, "wb");
+    if (output_file == nullptr) {
+        *this->error_stream << "Batch error: cannot open output file: " << output_path << '\n';
+        if (input != nullptr) {
+            munmap(input, input_size);
+        }
+
+        return false;
+    }
+
+    // Chunks go to the file as they are parsed, so the whole output is never held in memory.
+    bool is_written = true;
+    this->parse_chunks(std::string_view(static_cast<const char*>(input), input_size), [output_file, &is_written](const std::string& chunk_output) {
+        is_written = is_written && std::fwrite(chunk_output.data(), 1, chunk_output.size(), output_file) == chunk_output.size();
+    });
+
+    if (input != nullptr) {
+        munmap(input, input_size);
+    }
+
+    if (std::fclose(output_file) != 0 || !is_written) {
+        *this->error_stream << "Batch error: cannot write output file: " << output_path << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+BatchStats BatchParser::get_stats() const {
+    return this->stats;
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ArgParser.h"
+
+namespace ArgumentParser {
+
+struct BatchStats {
+    size_t line_count = 0;
+    size_t error_count = 0;
+};
+
+// Parses a file of command lines, one per line with whitespace-separated tokens, on a pool of
+// threads. Every worker builds its own parser once and reuses it for all of its lines.
+// Output has one line per input line in input order: the formatted result of a successful
+// parse, or "error: " followed by the parser's error messages.
+class BatchParser {
+public:
+    using ParserFactory = std::function<std::unique_ptr<ArgParser>()>;
+    // Appends the result of a successful parse to output, without a trailing newline.
+    using ResultFormatter = std::function<void(ArgParser& parser, std::string& output)>;
+private:
+    ParserFactory create_parser;
+    ResultFormatter format_result;
+
+    size_t thread_count = 0;
+    size_t chunk_size = 1024;
+    // Set to std::cerr by the constructor.
+    std::ostream* error_stream = nullptr;
+
+    BatchStats stats;
+
+    // Passes the output of every chunk of lines to write_chunk in input order, as soon as the chunk
+    // and all chunks before it are parsed, so only chunks finished out of order wait in memory.
+    void parse_chunks(std::string_view input, const std::function<void(const std::string& chunk_output)>& write_chunk);
+public:
+    // Without a formatter, a successful line is reported as "ok".
+    BatchParser(ParserFactory create_parser, ResultFormatter format_result = nullptr);
+
+    // Zero uses one thread per hardware thread.
+    void set_thread_count(size_t thread_count);
+
+    // Number of lines a worker takes, or steals, at a time.
+    void set_chunk_size(size_t chunk_size);
+
+    // Errors of parse_file that belong to no line, like an unreadable input, are written to stream
+    // instead of std::cerr. The stream is not owned and must outlive the batch parser.
+    void set_error_stream(std::ostream* stream);
+
+    // Maps input_path and writes the results to output_path.
+    bool parse_file(const char* input_path, const char* output_path);
+
+    void parse_lines(std::string_view input, std::string& output);
+
+    BatchStats get_stats() const;
+};
+
+} // namespace ArgumentParser
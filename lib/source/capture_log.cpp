@@ -0,0 +1,252 @@
+#include "capture_log.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ArgumentParser {
+
+namespace {
+
+constexpr uint32_t CAPTURE_MAGIC = 0x50414341;
+constexpr uint32_t CAPTURE_VERSION = 1;
+
+struct BlockHeader {
+    uint32_t magic = CAPTURE_MAGIC;
+    uint32_t version = CAPTURE_VERSION;
+    uint64_t size = 0;
+};
+
+void write_varint(std::string& buffer, uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+
+    buffer.push_back(static_cast<char>(value));
+}
+
+bool read_varint(const std::string& buffer, size_t& offset, size_t end, uint64_t& value) {
+    value = 0;
+    for (size_t shift = 0; shift < 64; shift += 7) {
+        if (offset == end) {
+            return false;
+        }
+
+        uint8_t byte = buffer[offset++];
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace
+
+CaptureLog::CaptureLog(const char* path, std::ostream& errors) {
+    this->file = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (this->file == -1) {
+        errors << "Capture error: cannot open capture log: " << path << '\n';
+        return;
+    }
+
+    this->buffer.reserve(FLUSH_THRESHOLD * 2);
+}
+
+CaptureLog::~CaptureLog() {
+    if (this->writer != nullptr) {
+        {
+            std::lock_guard lock(this->mutex);
+            this->is_stopping = true;
+        }
+
+        this->writer->flush_requested.notify_one();
+        this->writer->thread.join();
+    }
+
+    if (this->file != -1) {
+        close(this->file);
+    }
+}
+
+CaptureLog* CaptureLog::from_environment(std::ostream& errors) {
+    static CaptureLog* log = [&errors]() -> CaptureLog* {
+        const char* path = std::getenv(CAPTURE_LOG_VARIABLE);
+        if (path == nullptr || *path == '\0') {
+            return nullptr;
+        }
+
+        static CaptureLog environment_log(path, errors);
+        if (!environment_log.is_open()) {
+            return nullptr;
+        }
+
+        pthread_atfork(
+            [] { environment_log.prepare_fork(); },
+            [] { environment_log.resume_after_fork(); },
+            [] { environment_log.reset_after_fork(); });
+        return &environment_log;
+    }();
+
+    return log;
+}
+
+void CaptureLog::prepare_fork() {
+    this->mutex.lock();
+}
+
+void CaptureLog::resume_after_fork() {
+    this->mutex.unlock();
+}
+
+void CaptureLog::reset_after_fork() {
+    // The parent writes its own records; the child starts over with an empty buffer.
+    if (this->writer != nullptr) {
+        this->forked_writer = this->writer.release();
+    }
+
+    this->buffer.clear();
+    this->mutex.unlock();
+}
+
+bool CaptureLog::is_open() const {
+    return this->file != -1;
+}
+
+void CaptureLog::append(const TokenList& tokens, std::chrono::nanoseconds latency, bool is_successful) {
+    std::lock_guard lock(this->mutex);
+
+    if (this->writer == nullptr) {
+        this->writer = std::make_unique<Writer>();
+        this->writer->thread = std::thread(&CaptureLog::write_blocks, this, std::ref(*this->writer));
+    }
+
+    write_varint(this->buffer, latency.count());
+    this->buffer.push_back(is_successful);
+    write_varint(this->buffer, tokens.size());
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        std::string_view token = tokens[i];
+        write_varint(this->buffer, token.size());
+        this->buffer.append(token);
+    }
+
+    if (this->buffer.size() >= FLUSH_THRESHOLD) {
+        this->writer->flush_requested.notify_one();
+    }
+}
+
+void CaptureLog::write_blocks(Writer& writer) {
+    std::string records;
+    records.reserve(FLUSH_THRESHOLD * 2);
+
+    std::unique_lock lock(this->mutex);
+    while (true) {
+        writer.flush_requested.wait_for(lock, std::chrono::seconds(1), [this] {
+            return this->is_stopping || this->buffer.size() >= FLUSH_THRESHOLD;
+        });
+
+        if (!this->buffer.empty()) {
+            records.swap(this->buffer);
+            lock.unlock();
+
+            this->write_block(records);
+            records.clear();
+
+            lock.lock();
+        }
+
+        if (this->is_stopping && this->buffer.empty()) {
+            return;
+        }
+    }
+}
+
+void CaptureLog::write_block(const std::string& records) {
+    BlockHeader header;
+    header.size = records.size();
+
+    // Header and records go out in one append, so blocks of concurrent writers do not interleave.
+    iovec parts[] = {
+        {&header, sizeof(header)},
+        {const_cast<char*>(records.data()), records.size()},
+    };
+
+    ssize_t written = writev(this->file, parts, 2);
+    if (written != static_cast<ssize_t>(sizeof(header) + records.size())) {
+        std::cerr << "Capture error: cannot write capture log.\n";
+    }
+}
+
+bool CaptureLog::read(const char* path, std::vector<CapturedCommandLine>& command_lines) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        std::cerr << "Capture error: cannot open capture log: " << path << '\n';
+        return false;
+    }
+
+    std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    size_t offset = 0;
+    while (offset < contents.size()) {
+        BlockHeader header;
+        if (contents.size() - offset < sizeof(header)) {
+            std::cerr << "Capture error: capture log is truncated.\n";
+            return false;
+        }
+
+        std::memcpy(&header, contents.data() + offset, sizeof(header));
+        offset += sizeof(header);
+
+        if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION || header.size > contents.size() - offset) {
+            std::cerr << "Capture error: capture log is corrupted.\n";
+            return false;
+        }
+
+        size_t end = offset + header.size;
+        while (offset < end) {
+            CapturedCommandLine& command_line = command_lines.emplace_back();
+
+            uint64_t latency = 0;
+            uint64_t token_count = 0;
+            if (!read_varint(contents, offset, end, latency) || offset == end) {
+                std::cerr << "Capture error: capture log is corrupted.\n";
+                return false;
+            }
+
+            command_line.latency = std::chrono::nanoseconds(latency);
+            command_line.is_successful = contents[offset++] != 0;
+
+            if (!read_varint(contents, offset, end, token_count) || token_count > end - offset) {
+                std::cerr << "Capture error: capture log is corrupted.\n";
+                return false;
+            }
+
+            command_line.tokens.reserve(token_count);
+            for (uint64_t i = 0; i < token_count; i++) {
+                uint64_t size = 0;
+                if (!read_varint(contents, offset, end, size) || size > end - offset) {
+                    std::cerr << "Capture error: capture log is corrupted.\n";
+                    return false;
+                }
+
+                command_line.tokens.emplace_back(contents, offset, size);
+                offset += size;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "token_list.h"
+
+namespace ArgumentParser {
+
+// Name of the environment variable with the path of the capture log.
+inline constexpr const char* CAPTURE_LOG_VARIABLE = "ARGPARSER_CAPTURE";
+
+struct CapturedCommandLine {
+    std::vector<std::string> tokens;
+    std::chrono::nanoseconds latency = std::chrono::nanoseconds(0);
+    bool is_successful = false;
+};
+
+// Append-only binary log of parsed command lines and their parse latencies.
+// Records are encoded into a memory buffer and written by a background thread in blocks.
+// Every block starts with its own header, so several processes can append to one file.
+class CaptureLog {
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    // Background thread of one process, started by the first append.
+    struct Writer {
+        std::condition_variable flush_requested;
+        std::thread thread;
+    };
+
+    int file = -1;
+
+    std::mutex mutex;
+    std::string buffer;
+    bool is_stopping = false;
+    std::unique_ptr<Writer> writer;
+    // Writer of the parent process, which does not run in a forked child and is never joined.
+    Writer* forked_writer = nullptr;
+
+    void write_blocks(Writer& writer);
+
+    void write_block(const std::string& records);
+
+    // Fork handlers of the environment log: the mutex is held across fork, and the child drops
+    // the parent's writer and records, starting its own writer on its first append.
+    void prepare_fork();
+
+    void resume_after_fork();
+
+    void reset_after_fork();
+public:
+    // Open failures are written to errors.
+    CaptureLog(const char* path, std::ostream& errors);
+
+    CaptureLog(const CaptureLog&) = delete;
+
+    CaptureLog& operator=(const CaptureLog&) = delete;
+
+    // Writes the remaining records.
+    ~CaptureLog();
+
+    // Log named by ARGPARSER_CAPTURE, opened on first use and kept until exit; nullptr if unset.
+    // errors receives the open failure of the first call. The log keeps capturing in forked children.
+    static CaptureLog* from_environment(std::ostream& errors);
+
+    bool is_open() const;
+
+    void append(const TokenList& tokens, std::chrono::nanoseconds latency, bool is_successful);
+
+    // Reads all records of a log. Returns false if the file cannot be read or is corrupted.
+    static bool read(const char* path, std::vector<CapturedCommandLine>& command_lines);
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,15 @@
+#include "choice_argument.h"
+
+#include <ostream>
+
+namespace ArgumentParser {
+
+void report_invalid_choice(std::ostream& errors, std::string_view string_value, const std::vector<std::string_view>& choices) {
+    errors << "Parsing error: invalid choice '" << string_value << "'. Valid choices:";
+    for (std::string_view choice : choices) {
+        errors << ' ' << choice;
+    }
+    errors << '\n';
+}
+
+} // namespace ArgumentParser
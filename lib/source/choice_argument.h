@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "argument.h"
+#include "string_utils.h"
+
+namespace ArgumentParser {
+
+template <typename Enum> struct Choice {
+    std::string_view name;
+    Enum value;
+};
+
+// Compile-time table of (name, value) pairs with a perfect hash over the names.
+// Matching costs one hash of the token plus a single length check and memcmp.
+template <typename Enum, size_t N> class ChoiceTable {
+private:
+    static constexpr size_t SLOT_COUNT = std::bit_ceil(N * 4);
+    static constexpr uint64_t MAX_SEED = 1 << 16;
+
+    std::array<Choice<Enum>, N> choices;
+    // Index of the choice in a slot plus one, zero for an empty slot.
+    std::array<uint16_t, SLOT_COUNT> slots = {};
+    uint64_t seed = 0;
+
+    constexpr bool try_seed(uint64_t seed) {
+        this->slots = {};
+
+        for (size_t i = 0; i < N; i++) {
+            size_t slot = hash_string(this->choices[i].name, seed) & (SLOT_COUNT - 1);
+            if (this->slots[slot] != 0) {
+                return false;
+            }
+
+            this->slots[slot] = i + 1;
+        }
+
+        return true;
+    }
+public:
+    using value_type = Enum;
+
+    constexpr ChoiceTable(const Choice<Enum> (&choices)[N]) {
+        for (size_t i = 0; i < N; i++) {
+            this->choices[i] = choices[i];
+
+            for (size_t j = 0; j < i; j++) {
+                if (this->choices[j].name == choices[i].name) {
+                    throw std::logic_error("Choice names must be unique");
+                }
+            }
+        }
+
+        while (!this->try_seed(this->seed)) {
+            if (++this->seed == MAX_SEED) {
+                throw std::logic_error("Failed to build a perfect hash for choices");
+            }
+        }
+    }
+
+    constexpr const Choice<Enum>* find(std::string_view name) const {
+        uint16_t index = this->slots[hash_string(name, this->seed) & (SLOT_COUNT - 1)];
+        if (index == 0) {
+            return nullptr;
+        }
+
+        const Choice<Enum>& choice = this->choices[index - 1];
+        if (choice.name.size() != name.size() || std::memcmp(choice.name.data(), name.data(), name.size()) != 0) {
+            return nullptr;
+        }
+
+        return &choice;
+    }
+
+    constexpr size_t size() const {
+        return N;
+    }
+
+    constexpr const Choice<Enum>* begin() const {
+        return this->choices.data();
+    }
+
+    constexpr const Choice<Enum>* end() const {
+        return this->choices.data() + N;
+    }
+};
+
+template <typename Enum, size_t N>
+constexpr ChoiceTable<Enum, N> make_choice_table(const Choice<Enum> (&choices)[N]) {
+    return ChoiceTable<Enum, N>(choices);
+}
+
+void report_invalid_choice(std::ostream& errors, std::string_view string_value, const std::vector<std::string_view>& choices);
+
+template <const auto& choices>
+std::optional<typename std::remove_cvref_t<decltype(choices)>::value_type> parse_choice(const char* string_value, const std::optional<typename std::remove_cvref_t<decltype(choices)>::value_type>& default_value, std::ostream& errors) {
+    if (string_value == nullptr) {
+        return std::nullopt;
+    }
+
+    auto choice = choices.find(string_value);
+    if (choice == nullptr) {
+        std::vector<std::string_view> names;
+        for (auto& valid_choice : choices) {
+            names.push_back(valid_choice.name);
+        }
+
+        report_invalid_choice(errors, string_value, names);
+        return std::nullopt;
+    }
+
+    return choice->value;
+}
+
+// Argument that stores an enum value selected by name from a ChoiceTable with static storage duration.
+template <const auto& choices>
+class ChoiceArgument : public Argument<typename std::remove_cvref_t<decltype(choices)>::value_type, parse_choice<choices>> {
+public:
+    using Argument<typename std::remove_cvref_t<decltype(choices)>::value_type, parse_choice<choices>>::Argument;
+
+    std::vector<std::string_view> get_choices() override {
+        std::vector<std::string_view> names;
+        names.reserve(choices.size());
+
+        for (auto& choice : choices) {
+            names.push_back(choice.name);
+        }
+
+        return names;
+    }
+};
+
+} // namespace ArgumentParser
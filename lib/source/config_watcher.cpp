@@ -0,0 +1,288 @@
+#include "config_watcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace ArgumentParser {
+
+namespace {
+
+// How often the watcher checks for the destructor's stop flag if stop_event cannot be written.
+constexpr int STOP_CHECK_MILLISECONDS = 100;
+
+std::string_view trim(std::string_view line) {
+    size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+
+    return line.substr(begin, line.find_last_not_of(" \t\r") - begin + 1);
+}
+
+} // namespace
+
+std::string_view ConfigWatcher::ConfigLine::get_name() const {
+    return std::string_view(this->token).substr(2, this->name_size);
+}
+
+ConfigWatcher::ConfigWatcher(ParserFactory create_parser, std::vector<std::string> args, std::string config_path)
+    : create_parser(std::move(create_parser)), args(std::move(args)), config_path(std::move(config_path)) {}
+
+ConfigWatcher::~ConfigWatcher() {
+    if (this->watcher.joinable()) {
+        // The watcher uses this, so it is always joined. If the write fails, it sees the flag on
+        // its next periodic check instead.
+        this->is_stopping = true;
+        uint64_t stop = 1;
+        [[maybe_unused]] ssize_t written = write(this->stop_event, &stop, sizeof(stop));
+        this->watcher.join();
+    }
+
+    if (this->inotify_file != -1) {
+        close(this->inotify_file);
+    }
+
+    if (this->stop_event != -1) {
+        close(this->stop_event);
+    }
+}
+
+bool ConfigWatcher::start() {
+    if (!this->reload()) {
+        return false;
+    }
+
+    // Editors often replace the file instead of writing it, so the directory is watched.
+    size_t separator = this->config_path.rfind('/');
+    std::string directory = separator == std::string::npos ? "." : this->config_path.substr(0, separator + 1);
+
+    this->inotify_file = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    this->stop_event = eventfd(0, EFD_CLOEXEC);
+    if (this->inotify_file == -1 || this->stop_event == -1 || inotify_add_watch(this->inotify_file, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        this->result.load()->get_error_stream() << "Config error: cannot watch config file: " << this->config_path << '\n';
+        return false;
+    }
+
+    this->watcher = std::thread(&ConfigWatcher::watch, this);
+    return true;
+}
+
+void ConfigWatcher::watch() {
+    size_t separator = this->config_path.rfind('/');
+    std::string_view file_name = std::string_view(this->config_path).substr(separator == std::string::npos ? 0 : separator + 1);
+
+    alignas(inotify_event) char events[4096];
+    pollfd files[] = {
+        {this->inotify_file, POLLIN, 0},
+        {this->stop_event, POLLIN, 0},
+    };
+
+    while (!this->is_stopping) {
+        int ready_count = poll(files, 2, STOP_CHECK_MILLISECONDS);
+        if (ready_count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            this->result.load()->get_error_stream() << "Config error: cannot watch config file: " << this->config_path << '\n';
+            return;
+        }
+
+        if (ready_count == 0) {
+            continue;
+        }
+
+        if (files[1].revents != 0) {
+            return;
+        }
+
+        bool is_changed = false;
+        ssize_t size = 0;
+        while ((size = read(this->inotify_file, events, sizeof(events))) > 0) {
+            for (char* pointer = events; pointer < events + size;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(pointer);
+                is_changed |= event->len != 0 && file_name == event->name;
+                pointer += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        if (is_changed) {
+            this->reload();
+        }
+    }
+}
+
+bool ConfigWatcher::read_lines(std::ostream& errors) {
+    std::ifstream input(this->config_path, std::ios::binary);
+    if (!input) {
+        errors << "Config error: cannot open config file: " << this->config_path << '\n';
+        return false;
+    }
+
+    input.seekg(0, std::ios::end);
+    std::string contents(std::max<std::streamoff>(input.tellg(), 0), '\0');
+    input.seekg(0, std::ios::beg);
+    input.read(contents.data(), contents.size());
+    contents.resize(input.gcount());
+
+    std::vector<std::string_view> texts;
+    for (size_t begin = 0; begin < contents.size();) {
+        size_t end = std::min(contents.find('\n', begin), contents.size());
+        std::string_view text = trim(std::string_view(contents).substr(begin, end - begin));
+        if (!text.empty() && text[0] != '#') {
+            texts.push_back(text);
+        }
+
+        begin = end + 1;
+    }
+
+    size_t prefix = 0;
+    while (prefix < texts.size() && prefix < this->lines.size() && this->lines[prefix].text == texts[prefix]) {
+        prefix++;
+    }
+
+    size_t suffix = 0;
+    while (suffix < texts.size() - prefix && suffix < this->lines.size() - prefix
+        && this->lines[this->lines.size() - suffix - 1].text == texts[texts.size() - suffix - 1]) {
+        suffix++;
+    }
+
+    for (size_t i = prefix; i < this->lines.size() - suffix; i++) {
+        if (!this->lines[i].argument_name.empty()) {
+            this->unpublished_names.push_back(std::move(this->lines[i].argument_name));
+        }
+    }
+
+    std::vector<ConfigLine> new_lines;
+    new_lines.reserve(texts.size());
+    std::move(this->lines.begin(), this->lines.begin() + prefix, std::back_inserter(new_lines));
+
+    for (size_t i = prefix; i < texts.size() - suffix; i++) {
+        ConfigLine& line = new_lines.emplace_back();
+        line.text = texts[i];
+        line.token.reserve(texts[i].size() + 2);
+        line.token.append("--").append(texts[i]);
+        line.name_size = std::min(texts[i].find('='), texts[i].size());
+    }
+
+    std::move(this->lines.end() - suffix, this->lines.end(), std::back_inserter(new_lines));
+    this->lines = std::move(new_lines);
+    return true;
+}
+
+bool ConfigWatcher::reload() {
+    std::lock_guard lock(this->reload_mutex);
+
+    // Before the first result, the parser of the first parse reports the errors.
+    std::shared_ptr<ArgParser> previous = this->result.load();
+    std::shared_ptr<ArgParser> current = previous == nullptr ? this->create_parser() : nullptr;
+    if (!this->read_lines((previous != nullptr ? previous : current)->get_error_stream())) {
+        return false;
+    }
+
+    bool has_unmatched_lines = std::any_of(this->lines.begin(), this->lines.end(), [](const ConfigLine& line) {
+        return !line.is_matched;
+    });
+
+    if (previous != nullptr && this->unpublished_names.empty() && !has_unmatched_lines) {
+        return true;
+    }
+
+    // Building a parser costs more than copying every value, so the one replaced by the last reload
+    // is parsed into again once no reader holds it. Its own changed arguments are parsed again too.
+    bool is_reusing_parser = previous != nullptr && this->retired != nullptr && this->retired.use_count() == 1;
+    if (is_reusing_parser) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        current = std::move(this->retired);
+    } else if (current == nullptr) {
+        current = this->create_parser();
+    }
+
+    this->retired.reset();
+    if (!is_reusing_parser && !current->freeze()) {
+        return false;
+    }
+
+    for (ConfigLine& line : this->lines) {
+        if (line.is_matched) {
+            continue;
+        }
+
+        ArgumentBase* argument = current->lookup_long_name(line.get_name());
+        if (argument != nullptr && argument->get_name() != nullptr) {
+            line.argument_name = argument->get_name();
+            this->unpublished_names.push_back(line.argument_name);
+        }
+
+        line.is_matched = true;
+    }
+
+    // Every other argument has the same lines as in the published result, so its tokens are left out.
+    // Lines that match no argument are always kept, so that the parse reports them.
+    std::unordered_set<std::string_view> reparsed_set(this->unpublished_names.begin(), this->unpublished_names.end());
+    if (is_reusing_parser) {
+        reparsed_set.insert(this->retired_names.begin(), this->retired_names.end());
+    }
+
+    std::vector<std::string_view> reparsed_names(reparsed_set.begin(), reparsed_set.end());
+
+    std::vector<std::string_view> tokens;
+    tokens.reserve(this->args.size() + (previous == nullptr ? this->lines.size() : this->unpublished_names.size()));
+    tokens.push_back(this->args.empty() ? std::string_view() : std::string_view(this->args[0]));
+
+    for (const ConfigLine& line : this->lines) {
+        if (previous == nullptr || line.argument_name.empty() || reparsed_set.contains(line.argument_name)) {
+            tokens.push_back(line.token);
+        }
+    }
+
+    for (size_t i = 1; i < this->args.size(); i++) {
+        tokens.push_back(this->args[i]);
+    }
+
+    std::vector<const char*> changed_names;
+
+    if (previous == nullptr) {
+        if (!current->parse(std::span<const std::string_view>(tokens))) {
+            return false;
+        }
+    } else if (!current->parse_incremental(tokens, *previous, reparsed_names, changed_names)) {
+        return false;
+    }
+
+    this->result.store(current);
+    this->retired = previous;
+    this->retired_names = std::move(this->unpublished_names);
+    this->unpublished_names.clear();
+
+    for (const char* name : changed_names) {
+        auto callbacks = name != nullptr ? this->change_callbacks.find(name) : this->change_callbacks.end();
+        if (callbacks == this->change_callbacks.end()) {
+            continue;
+        }
+
+        for (const ChangeCallback& callback : callbacks->second) {
+            callback(*previous, *current);
+        }
+    }
+
+    return true;
+}
+
+std::shared_ptr<ArgParser> ConfigWatcher::get_result() const {
+    return this->result.load();
+}
+
+void ConfigWatcher::on_change(const char* argument_name, ChangeCallback callback) {
+    this->change_callbacks[argument_name].push_back(std::move(callback));
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ArgParser.h"
+
+namespace ArgumentParser {
+
+// Options of a long-running process taken from its command line and a config file, kept up to
+// date while the file is edited. Every line of the file is one long option without the dashes:
+//   level=3
+//   verbose
+//   # comment
+// Options that take a value need '='. The file is read before the command line, so single-value
+// options given on the command line override the file and multi-value ones add to it.
+//
+// On every change the file is read again, only the changed lines are turned into tokens, and only
+// the arguments named by changed lines are parsed again, into a new parser from the factory or
+// the one replaced by the last reload if no reader holds it anymore. The new parser is published
+// with an atomic pointer swap and then the change callbacks of the arguments whose values differ
+// are called. A file that does not parse keeps the last result. Errors are written to the error
+// stream of the parsers from the factory.
+class ConfigWatcher {
+public:
+    using ParserFactory = std::function<std::unique_ptr<ArgParser>()>;
+    using ChangeCallback = std::function<void(ArgParser& previous, ArgParser& current)>;
+private:
+    // One option line of the config file and its token, "--" followed by the line.
+    struct ConfigLine {
+        std::string text;
+        std::string token;
+        size_t name_size = 0;
+
+        // Full name of the argument the line sets, set by reload once the line is matched by the
+        // parser, so that abbreviations of one name are one argument. Empty if no argument matches.
+        std::string argument_name;
+        bool is_matched = false;
+
+        // The name as written on the line.
+        std::string_view get_name() const;
+    };
+
+    ParserFactory create_parser;
+    std::vector<std::string> args;
+    std::string config_path;
+
+    // Held by reload, which runs on the watcher thread and may be called directly.
+    std::mutex reload_mutex;
+
+    // Lines of the last read, kept to reuse the tokens of unchanged lines.
+    std::vector<ConfigLine> lines;
+    // Argument names of the lines changed since the published result, kept across reloads that fail
+    // to parse. Lines outside the changed range are equal, so no other argument can have different tokens.
+    std::vector<std::string> unpublished_names;
+
+    // The parser replaced by the last published result, and the names whose lines changed then.
+    std::shared_ptr<ArgParser> retired;
+    std::vector<std::string> retired_names;
+
+    std::atomic<std::shared_ptr<ArgParser>> result;
+    std::unordered_map<std::string, std::vector<ChangeCallback>> change_callbacks;
+
+    int inotify_file = -1;
+    int stop_event = -1;
+    // Set by the destructor; the watcher checks it on every wake-up of stop_event and periodically.
+    std::atomic<bool> is_stopping = false;
+    std::thread watcher;
+
+    // Reads the file into lines and adds the argument names of the replaced lines to
+    // unpublished_names. Lines outside the first and last changed ones keep their tokens, and
+    // the new ones are left unmatched.
+    bool read_lines(std::ostream& errors);
+
+    void watch();
+public:
+    // args is the command line of the process, the program name first.
+    ConfigWatcher(ParserFactory create_parser, std::vector<std::string> args, std::string config_path);
+
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // Parses the command line with the config file and starts watching the file.
+    // Returns false if the file cannot be read or the options do not parse.
+    bool start();
+
+    // Reads the config file again and publishes the new result if it parses.
+    // Called by the watcher thread on every change of the file.
+    bool reload();
+
+    // Latest successful result; the parser is shared with other readers and must only be read.
+    // Never waits for a reload. std::atomic<std::shared_ptr> is not lock-free in libstdc++, so
+    // concurrent calls may briefly spin on its internal lock while a pointer is copied.
+    std::shared_ptr<ArgParser> get_result() const;
+
+    // Called after a reload changes the value of the argument, on the thread running the reload,
+    // usually the watcher thread. Callbacks run while reload_mutex is held, so a callback that
+    // calls reload deadlocks. Register callbacks before start.
+    void on_change(const char* argument_name, ChangeCallback callback);
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Forces inlining where the compiler has a way to ask for it.
+#if defined(__GNUC__)
+#define ARGPARSER_ALWAYS_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+#define ARGPARSER_ALWAYS_INLINE __forceinline
+#else
+#define ARGPARSER_ALWAYS_INLINE inline
+#endif
+
+namespace ArgumentParser {
+
+// Bit i is set when data[i] is the delimiter, for the 16 bytes at data.
+inline uint32_t find_delimiter_mask(const char* data, char delimiter) {
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(delimiter)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < 16; i++) {
+        mask |= uint32_t(data[i] == delimiter) << i;
+    }
+
+    return mask;
+#endif
+}
+
+// Number of pieces the token splits into, one more than the number of delimiters.
+inline size_t count_pieces(std::string_view token, char delimiter) {
+    size_t count = 1;
+    size_t i = 0;
+    for (; i + 16 <= token.size(); i += 16) {
+        count += std::popcount(find_delimiter_mask(token.data() + i, delimiter));
+    }
+
+    for (; i < token.size(); i++) {
+        count += token[i] == delimiter;
+    }
+
+    return count;
+}
+
+// Calls on_piece with every piece of the token between delimiters, 16 bytes per comparison.
+// Stops and returns false as soon as on_piece does.
+template <typename OnPiece> bool for_each_piece(std::string_view token, char delimiter, OnPiece&& on_piece) {
+    const char* data = token.data();
+    size_t begin = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= token.size(); i += 16) {
+        uint32_t mask = find_delimiter_mask(data + i, delimiter);
+        while (mask != 0) {
+            size_t position = i + std::countr_zero(mask);
+            mask &= mask - 1;
+
+            if (!on_piece(std::string_view(data + begin, position - begin))) {
+                return false;
+            }
+
+            begin = position + 1;
+        }
+    }
+
+    for (; i < token.size(); i++) {
+        if (data[i] == delimiter) {
+            if (!on_piece(std::string_view(data + begin, i - begin))) {
+                return false;
+            }
+
+            begin = i + 1;
+        }
+    }
+
+    return on_piece(std::string_view(data + begin, token.size() - begin));
+}
+
+// Whether all 8 bytes of a little-endian word are ASCII digits.
+inline bool is_eight_digits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+// Value of 8 ASCII digits loaded as a little-endian word, combined pairwise in three multiplications.
+inline uint32_t parse_eight_digits(uint64_t chunk) {
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+
+// Same result as std::from_chars over the whole piece: an optional '-' for signed types,
+// at least one digit, nothing else, and no overflow.
+template <std::integral T> ARGPARSER_ALWAYS_INLINE std::optional<T> parse_decimal(std::string_view piece) {
+    const char* pointer = piece.data();
+    const char* end = pointer + piece.size();
+
+    bool is_negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (pointer != end && *pointer == '-') {
+            is_negative = true;
+            pointer++;
+        }
+    }
+
+    if (pointer == end) {
+        return std::nullopt;
+    }
+
+    uint64_t magnitude = 0;
+    if (end - pointer <= 19) {
+        // Up to 19 digits always fit, so neither loop checks for overflow.
+        if constexpr (std::endian::native == std::endian::little) {
+            while (end - pointer >= 8) {
+                uint64_t chunk;
+                std::memcpy(&chunk, pointer, sizeof(chunk));
+                if (!is_eight_digits(chunk)) {
+                    return std::nullopt;
+                }
+
+                magnitude = magnitude * 100000000 + parse_eight_digits(chunk);
+                pointer += 8;
+            }
+        }
+
+        for (; pointer != end; pointer++) {
+            uint8_t digit = *pointer - '0';
+            if (digit > 9) {
+                return std::nullopt;
+            }
+
+            magnitude = magnitude * 10 + digit;
+        }
+    } else {
+        // Longer pieces only fit with leading zeros.
+        for (; pointer != end; pointer++) {
+            uint8_t digit = *pointer - '0';
+            if (digit > 9) {
+                return std::nullopt;
+            }
+
+            if (magnitude > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                return std::nullopt;
+            }
+
+            magnitude = magnitude * 10 + digit;
+        }
+    }
+
+    using Unsigned = std::make_unsigned_t<T>;
+    if (is_negative) {
+        if (magnitude > uint64_t(std::numeric_limits<Unsigned>::max() / 2) + 1) {
+            return std::nullopt;
+        }
+
+        return static_cast<T>(Unsigned(0) - static_cast<Unsigned>(magnitude));
+    }
+
+    if (magnitude > uint64_t(std::numeric_limits<T>::max())) {
+        return std::nullopt;
+    }
+
+    return static_cast<T>(magnitude);
+}
+
+#undef ARGPARSER_ALWAYS_INLINE
+
+} // namespace ArgumentParser
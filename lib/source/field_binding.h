@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "argument.h"
+
+namespace ArgumentParser {
+
+// Converter used for a field of type T: from_chars for arithmetic types.
+template <typename T> constexpr ParserFunction<T> default_parser = parse_from_chars<T>;
+
+template <> constexpr ParserFunction<std::string> default_parser<std::string> = parse_string;
+
+template <> constexpr ParserFunction<bool> default_parser<bool> = parse_flag;
+
+// A std::vector<T> field is bound to a multi-value argument of T.
+template <typename T> struct FieldTraits {
+    using value_type = T;
+    static constexpr bool is_multi_value = false;
+};
+
+template <typename T> struct FieldTraits<std::vector<T>> {
+    using value_type = T;
+    static constexpr bool is_multi_value = true;
+};
+
+template <typename T> using FieldArgument = Argument<typename FieldTraits<T>::value_type, default_parser<typename FieldTraits<T>::value_type>>;
+
+// Maps a member of Struct to an argument name. Usually built with field and kept constexpr.
+template <typename Struct, typename T> struct FieldBinding {
+    T Struct::* member = nullptr;
+    char short_name = 0;
+    const char* name = nullptr;
+    const char* description = nullptr;
+};
+
+template <typename Struct, typename T>
+constexpr FieldBinding<Struct, T> field(T Struct::* member, const char* name, const char* description = nullptr) {
+    return {member, 0, name, description};
+}
+
+template <typename Struct, typename T>
+constexpr FieldBinding<Struct, T> field(T Struct::* member, char short_name, const char* name, const char* description = nullptr) {
+    return {member, short_name, name, description};
+}
+
+} // namespace ArgumentParser
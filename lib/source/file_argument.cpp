@@ -0,0 +1,87 @@
+#include "file_argument.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ArgumentParser {
+
+MappedFile::Mapping::~Mapping() {
+    if (this->data != nullptr) {
+        munmap(this->data, this->size);
+    }
+}
+
+std::optional<MappedFile> MappedFile::open(const char* path, std::ostream& errors) {
+    int file = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (file == -1) {
+        errors << "Parsing error: cannot open file '" << path << "': " << std::strerror(errno) << '\n';
+        return std::nullopt;
+    }
+
+    struct stat file_stat;
+    if (fstat(file, &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+        errors << "Parsing error: not a regular file: '" << path << "'\n";
+        close(file);
+        return std::nullopt;
+    }
+
+    MappedFile mapped_file;
+    mapped_file.mapping = std::make_shared<Mapping>();
+    mapped_file.mapping->path = path;
+    mapped_file.mapping->size = file_stat.st_size;
+
+    if (mapped_file.mapping->size > 0) {
+        void* data = mmap(nullptr, mapped_file.mapping->size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED) {
+            errors << "Parsing error: cannot map file '" << path << "': " << std::strerror(errno) << '\n';
+            close(file);
+            return std::nullopt;
+        }
+
+        // MADV_WILLNEED only queues readahead, so reading the file overlaps with the rest of the parse.
+        mapped_file.mapping->data = data;
+        madvise(data, mapped_file.mapping->size, MADV_WILLNEED);
+    }
+
+    close(file);
+    return mapped_file;
+}
+
+std::optional<MappedFile> MappedFile::open(const char* path) {
+    return MappedFile::open(path, std::cerr);
+}
+
+std::span<const std::byte> MappedFile::data() const {
+    if (this->mapping == nullptr) {
+        return {};
+    }
+
+    return {static_cast<const std::byte*>(this->mapping->data), this->mapping->size};
+}
+
+const std::string& MappedFile::path() const {
+    static const std::string empty_path;
+    if (this->mapping == nullptr) {
+        return empty_path;
+    }
+
+    return this->mapping->path;
+}
+
+std::optional<MappedFile> parse_mapped_file(const char* string_value, const std::optional<MappedFile>& default_value, std::ostream& errors) {
+    if (string_value == nullptr) {
+        return std::nullopt;
+    }
+
+    return MappedFile::open(string_value, errors);
+}
+
+template class Argument<MappedFile, parse_mapped_file>;
+
+} // namespace ArgumentParser
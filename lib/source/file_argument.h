@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "argument.h"
+
+namespace ArgumentParser {
+
+// Read-only mapping of a whole file. Copies share the mapping, which is unmapped with the last copy.
+class MappedFile {
+private:
+    struct Mapping {
+        std::string path;
+        void* data = nullptr;
+        size_t size = 0;
+
+        ~Mapping();
+    };
+
+    std::shared_ptr<Mapping> mapping;
+public:
+    // Maps the file and asks the kernel to start reading it in, which does not wait for the reads.
+    // Reports a failure to errors and returns std::nullopt.
+    static std::optional<MappedFile> open(const char* path, std::ostream& errors);
+
+    // Reports a failure to std::cerr.
+    static std::optional<MappedFile> open(const char* path);
+
+    std::span<const std::byte> data() const;
+
+    const std::string& path() const;
+};
+
+std::optional<MappedFile> parse_mapped_file(const char* string_value, const std::optional<MappedFile>& default_value, std::ostream& errors);
+
+// Input file path, mapped as soon as it is parsed so that reading it overlaps with the rest of the parse.
+typedef Argument<MappedFile, parse_mapped_file> FileArgument;
+
+extern template class Argument<MappedFile, parse_mapped_file>;
+
+} // namespace ArgumentParser
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <version>
+
+#if defined(__cpp_lib_generator)
+
+#include <generator>
+
+namespace ArgumentParser {
+
+template <typename T> using Generator = std::generator<T>;
+
+} // namespace ArgumentParser
+
+#else
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace ArgumentParser {
+
+// Minimal stand-in for std::generator on standard libraries that do not ship it yet.
+// Values are produced on demand each time the iterator is advanced.
+template <typename T> class Generator {
+public:
+    struct promise_type {
+        const T* current_value = nullptr;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        // The yielded object lives in the coroutine frame until the coroutine is resumed.
+        std::suspend_always yield_value(const T& value) noexcept {
+            this->current_value = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() {
+            throw;
+        }
+    };
+
+    class iterator {
+    private:
+        std::coroutine_handle<promise_type> coroutine = nullptr;
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+        const T& operator*() const {
+            return *this->coroutine.promise().current_value;
+        }
+
+        iterator& operator++() {
+            this->coroutine.resume();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return this->coroutine == nullptr || this->coroutine.done();
+        }
+    };
+
+    explicit Generator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    Generator(const Generator&) = delete;
+
+    Generator& operator=(const Generator&) = delete;
+
+    Generator(Generator&& other) noexcept : coroutine(std::exchange(other.coroutine, nullptr)) {}
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            this->destroy();
+            this->coroutine = std::exchange(other.coroutine, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~Generator() {
+        this->destroy();
+    }
+
+    iterator begin() {
+        this->coroutine.resume();
+        return iterator(this->coroutine);
+    }
+
+    std::default_sentinel_t end() {
+        return std::default_sentinel;
+    }
+private:
+    std::coroutine_handle<promise_type> coroutine = nullptr;
+
+    void destroy() {
+        if (this->coroutine != nullptr) {
+            this->coroutine.destroy();
+            this->coroutine = nullptr;
+        }
+    }
+};
+
+} // namespace ArgumentParser
+
+#endif
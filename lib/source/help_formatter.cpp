@@ -3,32 +3,43 @@
 namespace ArgumentParser {
 
 std::string DefaultHelpFormatter::format_argument_description(ArgumentBase& argument) const {
-    std::vector<std::string>* description_fragments = new std::vector<std::string>();        
+    std::vector<std::string> description_fragments;
 
     if (argument.get_short_name() != 0) {
-        description_fragments->emplace_back(new char[] {'-', argument.get_short_name(), 0});
+        description_fragments.push_back(std::string {'-', argument.get_short_name()});
     }
 
     if (argument.get_name() != nullptr) {
-        description_fragments->push_back(std::string("--") + argument.get_name());
+        description_fragments.push_back(std::string("--") + argument.get_name());
+    }
+
+    std::vector<std::string_view> choices = argument.get_choices();
+    if (!choices.empty()) {
+        std::string choices_description = "{";
+        for (size_t i = 0; i < choices.size(); i++) {
+            if (i > 0) {
+                choices_description += '|';
+            }
+
+            choices_description += choices[i];
+        }
+
+        description_fragments.push_back(choices_description + "}");
     }
 
     if (argument.get_description() != nullptr) {
-        description_fragments->emplace_back(argument.get_description());
+        description_fragments.emplace_back(argument.get_description());
     }
     
-    std::string description = join_strings(*description_fragments, ",\t");
-    delete description_fragments;
-
-    return description;
+    return join_strings(description_fragments, ",\t");
 }
 
-std::string DefaultHelpFormatter::format(const char* name, const char* parser_description, std::vector<ArgumentBase*>& arguments) const {
-    std::vector<std::string>* description_lines = new std::vector<std::string>();
-    description_lines->emplace_back(name);
+std::string DefaultHelpFormatter::format(const char* name, const char* parser_description, const std::vector<std::unique_ptr<ArgumentBase>>& arguments) const {
+    std::vector<std::string> description_lines;
+    description_lines.emplace_back(name);
 
     if (parser_description != nullptr) {
-        description_lines->emplace_back(parser_description);
+        description_lines.emplace_back(parser_description);
     }
 
     size_t positional_argument_count = 0;
@@ -36,7 +47,7 @@ std::string DefaultHelpFormatter::format(const char* name, const char* parser_de
     size_t option_count = 0;
     
     for (size_t i = 0; i < arguments.size(); i++) {
-        ArgumentBase* argument = arguments[i];
+        ArgumentBase* argument = arguments[i].get();
 
         if (argument->is_positional()) {
             positional_argument_count++;
@@ -52,38 +63,38 @@ std::string DefaultHelpFormatter::format(const char* name, const char* parser_de
     }
 
     if (positional_argument_count > 0) {
-        description_lines->emplace_back("\nPositional arguments:");
+        description_lines.emplace_back("\nPositional arguments:");
 
         for (size_t i = 0; i < arguments.size(); i++) {
-            ArgumentBase* argument = arguments[i];
+            ArgumentBase* argument = arguments[i].get();
 
             if (!argument->is_positional()) {
                 continue;
             }
             
-            description_lines->push_back(this->format_argument_description(*argument));
+            description_lines.push_back(this->format_argument_description(*argument));
         }
     }
 
     if (argument_count > 0) {
-        description_lines->emplace_back("\nArguments:");
+        description_lines.emplace_back("\nArguments:");
 
         for (size_t i = 0; i < arguments.size(); i++) {
-            ArgumentBase* argument = arguments[i];
+            ArgumentBase* argument = arguments[i].get();
 
             if (argument->is_positional() || argument->has_default_value()) {
                 continue;
             }
 
-            description_lines->push_back(this->format_argument_description(*argument));
+            description_lines.push_back(this->format_argument_description(*argument));
         }
     }
 
     if (option_count > 0) {
-        description_lines->emplace_back("\nOptions:");
+        description_lines.emplace_back("\nOptions:");
 
         for (size_t i = 0; i < arguments.size(); i++) {
-            ArgumentBase* argument = arguments[i];
+            ArgumentBase* argument = arguments[i].get();
 
             if (argument->is_positional()) {
                 continue;
@@ -93,14 +104,16 @@ std::string DefaultHelpFormatter::format(const char* name, const char* parser_de
                 continue;
             }
             
-            description_lines->push_back(this->format_argument_description(*argument));
+            description_lines.push_back(this->format_argument_description(*argument));
         }
     }
         
-    std::string description = join_strings(*description_lines, "\n");
-    delete description_lines;
+    return join_strings(description_lines, "\n");
+}
 
-    return description;
+const AbstractHelpFormatter& default_help_formatter() {
+    static const DefaultHelpFormatter formatter;
+    return formatter;
 }
 
 } // namespace ArgumentParser
@@ -2,6 +2,7 @@
 
 #include "argument.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -9,14 +10,19 @@ namespace ArgumentParser {
 
 class AbstractHelpFormatter {
 public:
-    virtual std::string format(const char* parser_name, const char* parser_description, std::vector<ArgumentBase*>& arguments) const = 0;
+    virtual ~AbstractHelpFormatter() = default;
+
+    virtual std::string format(const char* parser_name, const char* parser_description, const std::vector<std::unique_ptr<ArgumentBase>>& arguments) const = 0;
 };
 
 class DefaultHelpFormatter : public AbstractHelpFormatter {
 private:
     std::string format_argument_description(ArgumentBase& argument) const;
 public:
-    std::string format(const char* parser_name, const char* parser_description, std::vector<ArgumentBase*>& arguments) const override;
+    std::string format(const char* parser_name, const char* parser_description, const std::vector<std::unique_ptr<ArgumentBase>>& arguments) const override;
 };
 
-}
\ No newline at end of file
+// Shared formatter used by parsers that have no formatter set.
+const AbstractHelpFormatter& default_help_formatter();
+
+}
@@ -0,0 +1,97 @@
+#include "name_trie.h"
+
+#include <algorithm>
+
+namespace ArgumentParser {
+
+void NameTrie::build(std::vector<IndexedName> names) {
+    std::sort(names.begin(), names.end());
+
+    this->sorted_names = std::move(names);
+    this->nodes.clear();
+
+    // Bounded by the total length of the names, one node per character at most.
+    size_t total_length = 0;
+    for (const IndexedName& name : this->sorted_names) {
+        total_length += name.first.size();
+    }
+
+    this->nodes.reserve(total_length + 1);
+
+    Node root;
+    root.name_count = this->sorted_names.size();
+    root.is_terminal = !this->sorted_names.empty() && this->sorted_names[0].first.empty();
+    this->nodes.push_back(root);
+
+    std::vector<size_t> depths = {0};
+    depths.reserve(total_length + 1);
+
+    for (size_t node_index = 0; node_index < this->nodes.size(); node_index++) {
+        size_t depth = depths[node_index];
+        size_t name_index = this->nodes[node_index].first_name;
+        size_t name_end = name_index + this->nodes[node_index].name_count;
+
+        // Names that end at this node sort first. There may be several if names are duplicated.
+        while (name_index < name_end && this->sorted_names[name_index].first.size() == depth) {
+            name_index++;
+        }
+
+        this->nodes[node_index].first_child = this->nodes.size();
+
+        while (name_index < name_end) {
+            char character = this->sorted_names[name_index].first[depth];
+
+            Node child;
+            child.character = character;
+            child.first_name = name_index;
+            child.is_terminal = this->sorted_names[name_index].first.size() == depth + 1;
+
+            while (name_index < name_end && this->sorted_names[name_index].first[depth] == character) {
+                name_index++;
+            }
+
+            child.name_count = name_index - child.first_name;
+
+            this->nodes.push_back(child);
+            depths.push_back(depth + 1);
+            this->nodes[node_index].child_count++;
+        }
+    }
+}
+
+NameMatch NameTrie::find(std::string_view prefix) const {
+    NameMatch match;
+    if (this->nodes.empty()) {
+        return match;
+    }
+
+    const Node* node = &this->nodes[0];
+
+    for (char character : prefix) {
+        const Node* child = nullptr;
+        for (size_t i = 0; i < node->child_count; i++) {
+            const Node& candidate = this->nodes[node->first_child + i];
+            if (candidate.character == character) {
+                child = &candidate;
+                break;
+            }
+        }
+
+        if (child == nullptr) {
+            return match;
+        }
+
+        node = child;
+    }
+
+    match.candidates = std::span<const IndexedName>(this->sorted_names.data() + node->first_name, node->name_count);
+
+    if (node->is_terminal || node->name_count == 1) {
+        match.found = true;
+        match.argument_index = this->sorted_names[node->first_name].second;
+    }
+
+    return match;
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Argument name with the index of its argument in the parser.
+typedef std::pair<std::string_view, size_t> IndexedName;
+
+struct NameMatch {
+    // Index of the matched argument, valid only if found is true.
+    bool found = false;
+    size_t argument_index = 0;
+
+    // All names starting with the looked up prefix. More than one means the prefix is ambiguous.
+    std::span<const IndexedName> candidates;
+};
+
+// Compact trie over argument names for unique-prefix lookup.
+// Nodes are stored in breadth-first order, so the children of a node are contiguous,
+// and each node covers a contiguous range of the sorted names.
+class NameTrie {
+private:
+    struct Node {
+        uint32_t first_child = 0;
+        uint32_t child_count = 0;
+        uint32_t first_name = 0;
+        uint32_t name_count = 0;
+        char character = 0;
+        // The first name of the range is exactly the prefix of this node.
+        bool is_terminal = false;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<IndexedName> sorted_names;
+public:
+    void build(std::vector<IndexedName> names);
+
+    // Looks up an exact name or a prefix shared by exactly one name.
+    // Runs in O(prefix length) as the number of children of a node is bounded by the alphabet.
+    NameMatch find(std::string_view prefix) const;
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,100 @@
+#include "parse_cache.h"
+
+#include <cstring>
+
+#include "string_utils.h"
+
+namespace ArgumentParser {
+
+namespace {
+
+std::string encode_tokens(const TokenList& tokens) {
+    std::string encoded;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        std::string_view token = tokens[i];
+        uint32_t size = token.size();
+        encoded.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        encoded.append(token);
+    }
+
+    return encoded;
+}
+
+bool are_tokens_equal(const std::string& encoded, const TokenList& tokens) {
+    size_t offset = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        std::string_view token = tokens[i];
+        uint32_t size = token.size();
+        if (encoded.size() - offset < sizeof(size) + size) {
+            return false;
+        }
+
+        if (std::memcmp(encoded.data() + offset, &size, sizeof(size)) != 0) {
+            return false;
+        }
+
+        offset += sizeof(size);
+        if (encoded.compare(offset, size, token) != 0) {
+            return false;
+        }
+
+        offset += size;
+    }
+
+    return offset == encoded.size();
+}
+
+} // namespace
+
+ParseCache::ParseCache(size_t capacity) {
+    this->capacity = capacity;
+}
+
+uint64_t ParseCache::fingerprint(const TokenList& tokens) {
+    uint64_t hash = tokens.size();
+    for (size_t i = 0; i < tokens.size(); i++) {
+        std::string_view token = tokens[i];
+        hash = hash_bytes(token.data(), token.size(), hash);
+    }
+
+    return hash;
+}
+
+const std::vector<std::byte>* ParseCache::find(uint64_t fingerprint, const TokenList& tokens) {
+    auto iterator = this->entry_index.find(fingerprint);
+    if (iterator == this->entry_index.end() || !are_tokens_equal(iterator->second->tokens, tokens)) {
+        this->stats.misses++;
+        return nullptr;
+    }
+
+    this->entries.splice(this->entries.begin(), this->entries, iterator->second);
+    this->stats.hits++;
+    return &iterator->second->snapshot;
+}
+
+void ParseCache::insert(uint64_t fingerprint, const TokenList& tokens, std::vector<std::byte> snapshot) {
+    auto iterator = this->entry_index.find(fingerprint);
+    if (iterator != this->entry_index.end()) {
+        this->entries.erase(iterator->second);
+        this->entry_index.erase(iterator);
+    }
+
+    if (this->entries.size() == this->capacity) {
+        this->entry_index.erase(this->entries.back().fingerprint);
+        this->entries.pop_back();
+    }
+
+    this->entries.push_front({fingerprint, encode_tokens(tokens), std::move(snapshot)});
+    this->entry_index[fingerprint] = this->entries.begin();
+}
+
+void ParseCache::clear() {
+    this->entries.clear();
+    this->entry_index.clear();
+}
+
+ParseCacheStats ParseCache::get_stats() const {
+    return this->stats;
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "token_list.h"
+
+namespace ArgumentParser {
+
+struct ParseCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+// Bounded LRU cache from command lines to snapshots of their parse results.
+// Entries are looked up by a 64-bit fingerprint of the tokens and then compared
+// token by token, so fingerprint collisions never return a wrong result.
+class ParseCache {
+private:
+    struct Entry {
+        uint64_t fingerprint = 0;
+        // Tokens, each prefixed with its length.
+        std::string tokens;
+        std::vector<std::byte> snapshot;
+    };
+
+    size_t capacity = 0;
+    // Most recently used entries first.
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entry_index;
+
+    ParseCacheStats stats;
+public:
+    explicit ParseCache(size_t capacity);
+
+    static uint64_t fingerprint(const TokenList& tokens);
+
+    // Snapshot stored for tokens, or nullptr. Valid until the next call to insert or clear.
+    const std::vector<std::byte>* find(uint64_t fingerprint, const TokenList& tokens);
+
+    void insert(uint64_t fingerprint, const TokenList& tokens, std::vector<std::byte> snapshot);
+
+    void clear();
+
+    ParseCacheStats get_stats() const;
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace ArgumentParser {
+
+// Vector with inline storage for the first N elements.
+// Spills to the heap only when more than N values are stored.
+template <typename T, size_t N> class SmallVector {
+private:
+    alignas(T) std::byte inline_storage[N * sizeof(T)];
+
+    T* elements = reinterpret_cast<T*>(inline_storage);
+    size_t element_count = 0;
+    size_t element_capacity = N;
+
+    bool is_inline() const {
+        return this->elements == reinterpret_cast<const T*>(inline_storage);
+    }
+
+    void reallocate(size_t capacity) {
+        T* new_elements = static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+
+        std::uninitialized_move(this->elements, this->elements + this->element_count, new_elements);
+        std::destroy(this->elements, this->elements + this->element_count);
+        this->release();
+
+        this->elements = new_elements;
+        this->element_capacity = capacity;
+    }
+
+    void release() {
+        if (!this->is_inline()) {
+            ::operator delete(this->elements, std::align_val_t(alignof(T)));
+        }
+    }
+public:
+    SmallVector() = default;
+
+    SmallVector(const SmallVector&) = delete;
+
+    SmallVector& operator=(const SmallVector&) = delete;
+
+    ~SmallVector() {
+        this->clear();
+        this->release();
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity > this->element_capacity) {
+            this->reallocate(capacity);
+        }
+    }
+
+    template <typename... Args> T& emplace_back(Args&&... args) {
+        if (this->element_count == this->element_capacity) {
+            this->reallocate(this->element_capacity * 2);
+        }
+
+        T* element = new (this->elements + this->element_count) T(std::forward<Args>(args)...);
+        this->element_count++;
+        return *element;
+    }
+
+    void push_back(const T& value) {
+        this->emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        this->emplace_back(std::move(value));
+    }
+
+    void clear() {
+        std::destroy(this->elements, this->elements + this->element_count);
+        this->element_count = 0;
+    }
+
+    size_t size() const {
+        return this->element_count;
+    }
+
+    size_t capacity() const {
+        return this->element_capacity;
+    }
+
+    bool empty() const {
+        return this->element_count == 0;
+    }
+
+    T& operator[](size_t index) {
+        return this->elements[index];
+    }
+
+    const T& operator[](size_t index) const {
+        return this->elements[index];
+    }
+
+    T& back() {
+        return this->elements[this->element_count - 1];
+    }
+
+    T* begin() {
+        return this->elements;
+    }
+
+    T* end() {
+        return this->elements + this->element_count;
+    }
+
+    const T* begin() const {
+        return this->elements;
+    }
+
+    const T* end() const {
+        return this->elements + this->element_count;
+    }
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Appends plain bytes to a snapshot. Values are stored unaligned in native byte order,
+// so a snapshot contains no pointers and can be loaded at any address.
+class SnapshotWriter {
+private:
+    std::vector<std::byte>& buffer;
+public:
+    explicit SnapshotWriter(std::vector<std::byte>& buffer) : buffer(buffer) {}
+
+    void write(const void* data, size_t size) {
+        size_t offset = this->buffer.size();
+        this->buffer.resize(offset + size);
+        std::memcpy(this->buffer.data() + offset, data, size);
+    }
+
+    template <typename T> void write(const T& value) requires std::is_trivially_copyable_v<T> {
+        this->write(&value, sizeof(T));
+    }
+};
+
+// Reads values written by SnapshotWriter directly from the snapshot memory, e.g. shared memory.
+class SnapshotReader {
+private:
+    std::span<const std::byte> data;
+    size_t offset = 0;
+public:
+    explicit SnapshotReader(std::span<const std::byte> data) : data(data) {}
+
+    bool read(void* destination, size_t size) {
+        if (size > this->remaining()) {
+            return false;
+        }
+
+        std::memcpy(destination, this->data.data() + this->offset, size);
+        this->offset += size;
+        return true;
+    }
+
+    template <typename T> bool read(T& value) requires std::is_trivially_copyable_v<T> {
+        return this->read(&value, sizeof(T));
+    }
+
+    // Returns a view of the next size bytes without copying them.
+    const char* read_view(size_t size) {
+        if (size > this->remaining()) {
+            return nullptr;
+        }
+
+        const char* view = reinterpret_cast<const char*>(this->data.data() + this->offset);
+        this->offset += size;
+        return view;
+    }
+
+    size_t remaining() const {
+        return this->data.size() - this->offset;
+    }
+};
+
+// Encoding of argument values in snapshots. Trivially copyable values are copied as bytes,
+// strings are stored with their length. Other types cannot be snapshotted.
+template <typename T> struct ValueCodec {
+    static constexpr bool is_supported = std::is_trivially_copyable_v<T>;
+
+    static void write(SnapshotWriter& writer, const T& value) {
+        writer.write(value);
+    }
+
+    static std::optional<T> read(SnapshotReader& reader) {
+        T value;
+        if (!reader.read(value)) {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    static bool skip(SnapshotReader& reader) {
+        return reader.read_view(sizeof(T)) != nullptr;
+    }
+
+    static constexpr size_t min_size() {
+        return sizeof(T);
+    }
+};
+
+template <> struct ValueCodec<std::string> {
+    static constexpr bool is_supported = true;
+
+    static void write(SnapshotWriter& writer, const std::string& value) {
+        writer.write<uint64_t>(value.size());
+        writer.write(value.data(), value.size());
+    }
+
+    static std::optional<std::string> read(SnapshotReader& reader) {
+        uint64_t size = 0;
+        if (!reader.read(size)) {
+            return std::nullopt;
+        }
+
+        const char* view = reader.read_view(size);
+        if (view == nullptr) {
+            return std::nullopt;
+        }
+
+        return std::string(view, size);
+    }
+
+    static bool skip(SnapshotReader& reader) {
+        uint64_t size = 0;
+        return reader.read(size) && reader.read_view(size) != nullptr;
+    }
+
+    static constexpr size_t min_size() {
+        return sizeof(uint64_t);
+    }
+};
+
+} // namespace ArgumentParser
@@ -1,5 +1,8 @@
 #include "string_utils.h"
-#include "string_utils.h"
+
+#include <iterator>
+#include <sstream>
+#include <cstring>
 
 // Inspired by this: https://stackoverflow.com/a/5289170/14915825
 std::string join_strings(std::vector<std::string>& strings, const char* const delim) {
@@ -19,4 +22,33 @@ std::string join_strings(std::vector<std::string>& strings, const char* const de
     }
     
     return imploded.str();
-}
\ No newline at end of file
+}
+
+// Multiply-mix in the spirit of wyhash.
+static uint64_t mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t product = a * b;
+    return product ^ (product >> 32) ^ ((a >> 32) * (b >> 32));
+#endif
+}
+
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed ^ 0xa0761d6478bd642full;
+
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + offset, 8);
+        hash = mix(hash ^ word, 0xe7037ed1a0b428dbull);
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + offset, size - offset);
+    hash = mix(hash ^ tail, 0x8ebc6af09c88c6e3ull);
+
+    return mix(hash ^ size, 0x589965cc75374cc3ull);
+}
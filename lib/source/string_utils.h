@@ -1,9 +1,23 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <iterator>
-#include <sstream>
+#include <cstdint>
 
 // Copied from https://stackoverflow.com/a/5689061/14915825
-std::string join_strings(std::vector<std::string>& strings, const char* const delim);
\ No newline at end of file
+std::string join_strings(std::vector<std::string>& strings, const char* const delim);
+
+// Fast non-cryptographic hash of a byte range, processing eight bytes per step.
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0);
+
+// 64-bit FNV-1a, usable at compile time. The seed is mixed into the offset basis.
+constexpr uint64_t hash_string(std::string_view string, uint64_t seed = 0) {
+    uint64_t hash = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (char character : string) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash ^ (hash >> 32);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace ArgumentParser {
+
+// Non-owning view of the caller's argv, either as C strings, string views or strings.
+// Tokens must be null-terminated, as argv and std::string are; ArgParser copies the caller's
+// string views before viewing them here.
+class TokenList {
+private:
+    const char* const* c_strings = nullptr;
+    const std::string_view* string_views = nullptr;
+    const std::string* strings = nullptr;
+    size_t token_count = 0;
+public:
+    TokenList() = default;
+
+    TokenList(std::span<const char* const> tokens) : c_strings(tokens.data()), token_count(tokens.size()) {}
+
+    TokenList(std::span<const std::string_view> tokens) : string_views(tokens.data()), token_count(tokens.size()) {}
+
+    TokenList(std::span<const std::string> tokens) : strings(tokens.data()), token_count(tokens.size()) {}
+
+    std::string_view operator[](size_t index) const {
+        if (this->string_views != nullptr) {
+            return this->string_views[index];
+        }
+
+        if (this->strings != nullptr) {
+            return this->strings[index];
+        }
+
+        return this->c_strings[index];
+    }
+
+    size_t size() const {
+        return this->token_count;
+    }
+};
+
+// Half-open range [begin, end) of token indices.
+struct TokenRange {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+} // namespace ArgumentParser
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Bench {
+
+// Number of global operator new calls since program start.
+size_t allocation_count();
+
+} // namespace Bench
@@ -1,8 +1,17 @@
 #include <sstream>
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <gtest/gtest.h>
 #include <argparser.h>
+#include <batch_parser.h>
+#include <capture_log.h>
+#include <config_watcher.h>
 
 using namespace ArgumentParser;
 
@@ -17,6 +26,19 @@ std::vector<std::string> split_string(const std::string& str) {
 }
 
 
+// Path of a file in the temporary directory that only the current test of this test binary uses,
+// so the plain and the LeakSanitizer suites can run side by side under ctest -j.
+std::string get_temp_path(const std::string& file_name) {
+#ifdef ARGPARSER_LEAK_CHECK
+    std::string binary_name = "lsan_";
+#else
+    std::string binary_name;
+#endif
+
+    return testing::TempDir() + "argparser_" + binary_name + testing::UnitTest::GetInstance()->current_test_info()->name() + "_" + file_name;
+}
+
+
 TEST(ArgParserTestSuite, EmptyTest) {
     ArgParser parser("My Empty Parser");
 
@@ -80,6 +102,32 @@ TEST(ArgParserTestSuite, MultiStringTest) {
 }
 
 
+TEST(ArgParserTestSuite, AbbreviationTest) {
+    ArgParser parser("My Parser");
+    parser.set_allow_abbreviations(true);
+    parser.add_flag("verbose");
+    parser.add_flag("version");
+    parser.add_string_argument("output");
+    parser.add_string_argument("out");
+
+    ASSERT_TRUE(parser.parse(split_string("app --verb --outp=file --out=dir")));
+    ASSERT_TRUE(parser.get_flag("verbose"));
+    ASSERT_FALSE(parser.get_flag("version"));
+    ASSERT_EQ(parser.get_string_value("output"), "file");
+    ASSERT_EQ(parser.get_string_value("out"), "dir");
+
+    ASSERT_FALSE(parser.parse(split_string("app --ver --out=dir")));
+}
+
+
+TEST(ArgParserTestSuite, NoAbbreviationTest) {
+    ArgParser parser("My Parser");
+    parser.add_flag("verbose");
+
+    ASSERT_FALSE(parser.parse(split_string("app --verb")));
+}
+
+
 TEST(ArgParserTestSuite, IntTest) {
     ArgParser parser("My Parser");
     parser.add_int_argument("param1");
@@ -89,6 +137,25 @@ TEST(ArgParserTestSuite, IntTest) {
 }
 
 
+TEST(ArgParserTestSuite, LambdaConverterTest) {
+    constexpr auto parse_hex = [](const char* string_value, const std::optional<int>&) -> std::optional<int> {
+        int value = 0;
+        auto [pointer, error_code] = std::from_chars(string_value, string_value + strlen(string_value), value, 16);
+        if (error_code != std::errc() || *pointer != '\0') {
+            return std::nullopt;
+        }
+
+        return value;
+    };
+
+    ArgParser parser("My Parser");
+    parser.add_argument<Argument<int, parse_hex>>("param1", "Hex number");
+
+    ASSERT_TRUE(parser.parse(split_string("app --param1=ff")));
+    ASSERT_EQ(parser.get_int_value("param1"), 255);
+}
+
+
 TEST(ArgParserTestSuite, MultiValueTest) {
     ArgParser parser("My Parser");
     std::vector<int> int_values;
@@ -101,6 +168,18 @@ TEST(ArgParserTestSuite, MultiValueTest) {
 }
 
 
+TEST(ArgParserTestSuite, InlineMultiValueTest) {
+    ArgParser parser("My Parser");
+    parser.add_int_argument("Param1").mark_multi_value(1, 4).mask_positional();
+
+    ASSERT_TRUE(parser.parse(split_string("app 1 2 3 4 5 6 7 8 9 10 11 12")));
+    ASSERT_EQ(parser.get_argument<IntArgument>("Param1").get_value_count(), 12);
+    ASSERT_EQ(parser.get_int_value("Param1", 0), 1);
+    ASSERT_EQ(parser.get_int_value("Param1", 8), 9);
+    ASSERT_EQ(parser.get_int_value("Param1", 11), 12);
+}
+
+
 TEST(ArgParserTestSuite, MinCountMultiValueTest) {
     ArgParser parser("My Parser");
     std::vector<int> int_values;
@@ -111,6 +190,56 @@ TEST(ArgParserTestSuite, MinCountMultiValueTest) {
 }
 
 
+enum class Mode {
+    Fast,
+    Safe,
+    Debug,
+};
+
+constexpr auto MODES = make_choice_table<Mode>({
+    {"fast", Mode::Fast},
+    {"safe", Mode::Safe},
+    {"debug", Mode::Debug},
+});
+
+TEST(ArgParserTestSuite, ChoiceTest) {
+    ArgParser parser("My Parser");
+    parser.add_choice_argument<MODES>('m', "mode", "Execution mode");
+
+    ASSERT_TRUE(parser.parse(split_string("app --mode=safe")));
+    ASSERT_EQ(parser.get_argument_value<Mode>("mode"), Mode::Safe);
+    ASSERT_NE(parser.get_help_description().find("{fast|safe|debug}"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, InvalidChoiceTest) {
+    ArgParser parser("My Parser");
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    parser.add_choice_argument<MODES>("mode").set_default_value(Mode::Fast);
+
+    ASSERT_FALSE(parser.parse(split_string("app --mode=slow")));
+    ASSERT_EQ(errors.str(), "Parsing error: invalid choice 'slow'. Valid choices: fast safe debug\n");
+    ASSERT_FALSE(parser.parse(split_string("app --mode=fas")));
+}
+
+
+TEST(ArgParserTestSuite, InvalidValueTest) {
+    ArgParser parser("My Parser");
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    parser.add_int_argument('n', "number");
+    parser.add_int_argument("Param1").mark_multi_value().mask_positional();
+
+    ASSERT_FALSE(parser.parse(split_string("app --number=abc")));
+    ASSERT_EQ(errors.str(), "Parsing error: invalid value 'abc'. Argument name: number\n");
+
+    errors.str("");
+    ASSERT_FALSE(parser.parse(split_string("app 1 x")));
+    ASSERT_EQ(errors.str(), "Parsing error: invalid value 'x'. Argument name: Param1\n");
+}
+
+
 TEST(ArgParserTestSuite, FlagTest) {
     ArgParser parser("My Parser");
     parser.add_flag('f', "flag1");
@@ -134,6 +263,40 @@ TEST(ArgParserTestSuite, FlagsTest) {
 }
 
 
+TEST(ArgParserTestSuite, MutuallyExclusiveGroupTest) {
+    ArgParser parser("My Parser");
+    parser.add_flag('q', "quiet");
+    parser.add_flag('v', "verbose");
+    parser.add_mutually_exclusive_group({"quiet", "verbose"});
+
+    ASSERT_TRUE(parser.parse(split_string("app -q")));
+    ASSERT_FALSE(parser.parse(split_string("app -q -v")));
+}
+
+
+TEST(ArgParserTestSuite, RequirementTest) {
+    ArgParser parser("My Parser");
+    parser.add_string_argument("user").set_default_value("root");
+    parser.add_string_argument("password").set_default_value("");
+    parser.add_requirement("password", {"user"});
+
+    ASSERT_TRUE(parser.parse(split_string("app --user=admin")));
+    ASSERT_TRUE(parser.parse(split_string("app --user=admin --password=secret")));
+    ASSERT_FALSE(parser.parse(split_string("app --password=secret")));
+}
+
+
+TEST(ArgParserTestSuite, AtLeastOneOfGroupTest) {
+    ArgParser parser("My Parser");
+    parser.add_flag("sum");
+    parser.add_flag("mult");
+    parser.add_at_least_one_of_group({"sum", "mult"});
+
+    ASSERT_TRUE(parser.parse(split_string("app --mult")));
+    ASSERT_FALSE(parser.parse(split_string("app")));
+}
+
+
 TEST(ArgParserTestSuite, PositionalArgTest) {
     ArgParser parser("My Parser");
     std::vector<int> values;
@@ -162,6 +325,637 @@ TEST(ArgParserTestSuite, PositionalAndNormalArgTest) {
 }
 
 
+TEST(ArgParserTestSuite, LazyPositionalArgTest) {
+    ArgParser parser("My Parser");
+    IntArgument& argument = parser.add_int_argument("Param1").mark_multi_value(2).mask_positional();
+    parser.add_flag('f', "flag", "Flag");
+
+    std::vector<std::string> args = split_string("app 1 2 -f 3 x 5");
+    std::vector<std::string_view> arg_views(args.begin(), args.end());
+    ASSERT_TRUE(parser.parse_lazy(arg_views));
+    ASSERT_TRUE(parser.get_flag("flag"));
+    ASSERT_EQ(argument.get_value_count(), 0);
+
+    std::vector<std::optional<int>> values;
+    for (std::optional<int> value : parser.lazy_values(argument)) {
+        values.push_back(value);
+    }
+
+    ASSERT_EQ(values.size(), 5);
+    ASSERT_EQ(values[2], 3);
+    ASSERT_FALSE(values[3].has_value());
+    ASSERT_EQ(values[4], 5);
+}
+
+
+TEST(ArgParserTestSuite, ArgvSpanTest) {
+    ArgParser parser("My Parser");
+    parser.add_string_argument("Param1").mark_multi_value(1).mask_positional();
+    parser.add_flag('f', "flag", "Flag");
+
+    const char* argv[] = {"app", "a", "-f", "b", "--", "-c"};
+    ASSERT_TRUE(parser.parse(std::span<const char* const>(argv)));
+    ASSERT_TRUE(parser.get_flag("flag"));
+    ASSERT_EQ(parser.get_string_value("Param1", 0), "a");
+    ASSERT_EQ(parser.get_string_value("Param1", 1), "b");
+    ASSERT_EQ(parser.get_string_value("Param1", 2), "-c");
+}
+
+
+TEST(ArgParserTestSuite, SubstringViewTest) {
+    ArgParser parser("My Parser");
+    parser.add_int_argument("number");
+    parser.add_string_argument("Param1").mark_multi_value(1).mask_positional();
+
+    // None of the views is null-terminated: each is followed by more digits or letters.
+    std::string buffer = "app--number=12345input";
+    std::string_view text = buffer;
+    std::vector<std::string_view> args = {text.substr(0, 3), text.substr(3, 11), text.substr(17, 2)};
+    ASSERT_TRUE(parser.parse(args));
+    ASSERT_EQ(parser.get_int_value("number"), 12);
+    ASSERT_EQ(parser.get_string_value("Param1", 0), "in");
+
+    ASSERT_TRUE(parser.parse_lazy(args));
+    ASSERT_EQ(parser.get_int_value("number"), 12);
+}
+
+
+struct BoundOptions {
+    std::string output = "out.txt";
+    int level = 1;
+    bool verbose = false;
+    std::vector<int> values;
+};
+
+
+TEST(ArgParserTestSuite, BindFieldsTest) {
+    BoundOptions options;
+    ArgParser parser("My Parser");
+    parser.bind_fields(options,
+        field(&BoundOptions::output, 'o', "output", "Output file"),
+        field(&BoundOptions::level, "level"),
+        field(&BoundOptions::verbose, 'v', "verbose"));
+    parser.bind_field(options, field(&BoundOptions::values, "N")).mask_positional();
+
+    ASSERT_TRUE(parser.parse(split_string("app -v --level=3 1 2")));
+    ASSERT_TRUE(options.verbose);
+    ASSERT_EQ(options.level, 3);
+    ASSERT_EQ(options.output, "out.txt");
+    ASSERT_EQ(options.values, std::vector<int>({1, 2}));
+    ASSERT_EQ(parser.get_int_value("level"), 3);
+
+    // The vector field is appended to by every parse.
+    options.values.clear();
+    ASSERT_TRUE(parser.parse(split_string("app -o=result.txt 4")));
+    ASSERT_FALSE(options.verbose);
+    ASSERT_EQ(options.level, 1);
+    ASSERT_EQ(options.output, "result.txt");
+    ASSERT_EQ(options.values, std::vector<int>({4}));
+}
+
+
+TEST(ArgParserTestSuite, FreezeTest) {
+    ArgParser parser("My Parser");
+    parser.add_string_argument('i', "input", "Input");
+    parser.add_int_argument("Param1").mark_multi_value(1).mask_positional();
+    ASSERT_TRUE(parser.freeze());
+    ASSERT_FALSE(parser.parse(split_string("app 1 2")));
+    ASSERT_FALSE(parser.parse(split_string("app -i=file")));
+    ASSERT_TRUE(parser.parse(split_string("app -i=file 1 2")));
+
+    // Param1 keeps its minimum and the last unbounded positional takes the rest.
+    parser.add_int_argument("Param2").mask_positional();
+    ASSERT_TRUE(parser.freeze());
+    ASSERT_TRUE(parser.parse(split_string("app -i=file 1 2 3")));
+    ASSERT_EQ(parser.get_argument<IntArgument>("Param1").get_value_count(), 1);
+    ASSERT_EQ(parser.get_argument<IntArgument>("Param2").get_value_count(), 2);
+
+    parser.add_int_argument("input");
+    ASSERT_FALSE(parser.freeze());
+    ASSERT_FALSE(parser.parse(split_string("app -i=file 1 2")));
+}
+
+
+TEST(ArgParserTestSuite, PositionalArityTest) {
+    ArgParser parser("My Parser");
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    parser.add_string_argument("Mode").mask_positional(1, 1);
+    parser.add_int_argument("Extra").mask_positional(0, 3);
+    parser.add_string_argument("Src").mask_positional(1);
+    parser.add_string_argument("Dst").mask_positional(1, 1);
+
+    ASSERT_TRUE(parser.parse(split_string("app copy 1 2 3 a b c")));
+    ASSERT_EQ(parser.get_string_value("Mode"), "copy");
+    ASSERT_EQ(parser.get_argument<IntArgument>("Extra").get_value_count(), 3);
+    ASSERT_EQ(parser.get_argument<StringArgument>("Src").get_value_count(), 2);
+    ASSERT_EQ(parser.get_string_value("Dst"), "c");
+
+    // Extra takes what it can while leaving one token each for Src and Dst.
+    ASSERT_TRUE(parser.parse(split_string("app copy 1 a b")));
+    ASSERT_EQ(parser.get_int_value("Extra", 0), 1);
+    ASSERT_EQ(parser.get_string_value("Src", 0), "a");
+    ASSERT_EQ(parser.get_string_value("Dst"), "b");
+
+    ASSERT_FALSE(parser.parse(split_string("app copy a")));
+    ASSERT_EQ(errors.str(), "Parsing error: argument value count is less than required. Argument name: Dst\n");
+}
+
+
+TEST(ArgParserTestSuite, PositionalArityErrorTest) {
+    ArgParser parser("My Parser");
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    parser.add_string_argument("Src").mask_positional(1, 2);
+    parser.add_string_argument("Dst").mask_positional(1, 1);
+
+    ASSERT_FALSE(parser.parse(split_string("app a b c d")));
+    ASSERT_EQ(errors.str(), "Parsing error: too many positional arguments. Unexpected value: d\n");
+}
+
+
+TEST(ArgParserTestSuite, PositionalAfterUnboundedTest) {
+    ArgParser parser("My Parser");
+    parser.add_string_argument("Src").mask_positional(1);
+    parser.add_string_argument("Dst").mask_positional(1, 1);
+    parser.add_int_argument("Extra").mask_positional(0, 3);
+
+    // After Src, the positionals are filled from the last one backwards.
+    ASSERT_TRUE(parser.parse(split_string("app a b c 1 2 3")));
+    ASSERT_EQ(parser.get_argument<StringArgument>("Src").get_value_count(), 2);
+    ASSERT_EQ(parser.get_string_value("Dst"), "c");
+    ASSERT_EQ(parser.get_argument<IntArgument>("Extra").get_value_count(), 3);
+
+    ASSERT_TRUE(parser.parse(split_string("app a b 1")));
+    ASSERT_EQ(parser.get_string_value("Src", 0), "a");
+    ASSERT_EQ(parser.get_string_value("Dst"), "b");
+    ASSERT_EQ(parser.get_int_value("Extra", 0), 1);
+
+    ASSERT_TRUE(parser.parse(split_string("app a b")));
+    ASSERT_EQ(parser.get_string_value("Dst"), "b");
+    ASSERT_EQ(parser.get_argument<IntArgument>("Extra").get_value_count(), 0);
+
+    // Of several unbounded positionals, the last one takes every token beyond the minimums of the
+    // ones before it.
+    parser.add_string_argument("More").mask_positional(1);
+    ASSERT_TRUE(parser.parse(split_string("app a b x y")));
+    ASSERT_EQ(parser.get_argument<StringArgument>("Src").get_value_count(), 1);
+    ASSERT_EQ(parser.get_string_value("Dst"), "b");
+    ASSERT_EQ(parser.get_argument<IntArgument>("Extra").get_value_count(), 0);
+    ASSERT_EQ(parser.get_argument<StringArgument>("More").get_value_count(), 2);
+}
+
+
+TEST(ArgParserTestSuite, NameLookupTest) {
+    ArgParser parser("My Parser");
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    parser.add_string_argument('s', "string", "String");
+    parser.add_flag('a', "alpha", "Alpha");
+    parser.add_flag('b', "beta", "Beta");
+
+    ASSERT_TRUE(parser.parse(split_string("app --string=a=b")));
+    ASSERT_EQ(parser.get_string_value("string"), "a=b");
+    ASSERT_TRUE(parser.parse(split_string("app -s==x -abba")));
+    ASSERT_EQ(parser.get_string_value("string"), "=x");
+    ASSERT_TRUE(parser.get_flag("alpha") && parser.get_flag("beta"));
+
+    ASSERT_FALSE(parser.parse(split_string("app --strin=x")));
+    ASSERT_FALSE(parser.parse(split_string("app -s=x -abc")));
+    ASSERT_EQ(errors.str(), "Unknown argument name: strin\nUnknown short argument name: c\n");
+
+    // The lookup tables are rebuilt after new arguments are added.
+    parser.add_flag('c', "gamma", "Gamma");
+    ASSERT_TRUE(parser.parse(split_string("app -s=x -abc --gamma")));
+}
+
+
+TEST(ArgParserTestSuite, CompletionTest) {
+    ArgParser parser("My Parser");
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    parser.add_choice_argument<MODES>('m', "mode", "Execution mode");
+    parser.add_string_argument('o', "output", "Output");
+    parser.add_string_argument("include", "Include").mark_multi_value();
+    parser.add_flag("fast", "Fast");
+    parser.add_flag("safe", "Safe");
+    parser.add_choice_argument<MODES>("target", "Target").mask_positional();
+    parser.add_mutually_exclusive_group({"fast", "safe"});
+
+    std::vector<std::string> args = split_string("app --output=x --fast --");
+    CompletionResult result = parser.complete(args, 2);
+    ASSERT_EQ(result.options, std::vector<std::string>({"--fast"}));
+
+    result = parser.complete(args, 3);
+    ASSERT_EQ(result.options, std::vector<std::string>({"--include", "--mode"}));
+
+    result = parser.complete(args, 4);
+    ASSERT_TRUE(result.options.empty());
+    ASSERT_EQ(result.values.size(), 3);
+
+    result = parser.complete(split_string("app --mode"), 2);
+    ASSERT_EQ(result.value_argument->get_name(), std::string("mode"));
+    ASSERT_EQ(result.values, std::vector<std::string_view>({"fast", "safe", "debug"}));
+
+    result = parser.complete(split_string("app -m=s"), 1);
+    ASSERT_EQ(result.values, std::vector<std::string_view>({"safe"}));
+
+    result = parser.complete(split_string("app --unknown -- d"), 3);
+    ASSERT_EQ(result.value_argument->get_name(), std::string("target"));
+    ASSERT_EQ(result.values, std::vector<std::string_view>({"debug"}));
+    ASSERT_TRUE(result.options.empty());
+
+    result = parser.complete(split_string("app -"), 1);
+    ASSERT_EQ(result.options, std::vector<std::string>({"-m", "-o", "--fast", "--include", "--mode", "--output", "--safe"}));
+
+    // A constraint added after completing is compiled by the next completion.
+    parser.add_mutually_exclusive_group({"output", "include"});
+    result = parser.complete(args, 3);
+    ASSERT_EQ(result.options, std::vector<std::string>({"--mode"}));
+    ASSERT_EQ(errors.str(), "");
+}
+
+
+TEST(ArgParserTestSuite, ConfigWatcherTest) {
+    std::string path = get_temp_path("config.conf");
+    std::ofstream(path) << "level=1\n# comment\nname=first\ninclude=a\n";
+
+    ConfigWatcher watcher([] {
+        auto parser = std::make_unique<ArgParser>("Daemon");
+        parser->add_int_argument("level");
+        parser->add_string_argument("name");
+        parser->add_string_argument("include").mark_multi_value();
+        parser->add_flag("verbose");
+        return parser;
+    }, {"daemon", "--level=2", "--include=b"}, path);
+
+    std::vector<std::string> changes;
+    watcher.on_change("name", [&changes](ArgParser& previous, ArgParser& current) {
+        changes.push_back(previous.get_string_value("name") + ">" + current.get_string_value("name"));
+    });
+    watcher.on_change("level", [&changes](ArgParser&, ArgParser&) {
+        changes.push_back("level");
+    });
+
+    ASSERT_TRUE(watcher.start());
+    std::shared_ptr<ArgParser> first = watcher.get_result();
+    ASSERT_EQ(first->get_int_value("level"), 2);
+    ASSERT_EQ(first->get_string_value("include", 1), "b");
+
+    // The command line still overrides the level, so only the name callback fires.
+    std::ofstream(path) << "level=5\nname=second\ninclude=a\nverbose\n";
+    ASSERT_TRUE(watcher.reload());
+    ASSERT_EQ(changes, std::vector<std::string>({"first>second"}));
+    std::shared_ptr<ArgParser> second = watcher.get_result();
+    ASSERT_EQ(second->get_int_value("level"), 2);
+    ASSERT_TRUE(second->get_flag("verbose"));
+    ASSERT_EQ(second->get_string_value("include", 0), "a");
+    ASSERT_EQ(first->get_string_value("name"), "first");
+
+    std::ofstream(path) << "level=5\nname=third\n";
+    for (int i = 0; i < 500 && watcher.get_result() == second; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(watcher.get_result()->get_string_value("name"), "third");
+    ASSERT_EQ(watcher.get_result()->get_argument<StringArgument>("include").get_value_count(), 1);
+}
+
+
+TEST(ArgParserTestSuite, ConfigWatcherReusedParserTest) {
+    std::string path = get_temp_path("config.conf");
+    std::ofstream(path) << "level=1\nname=a\n";
+
+    ConfigWatcher watcher([] {
+        auto parser = std::make_unique<ArgParser>("Daemon");
+        parser->add_int_argument("level");
+        parser->add_string_argument("name");
+        return parser;
+    }, {"daemon"}, path);
+
+    std::vector<std::string> changes;
+    for (const char* name : {"level", "name"}) {
+        watcher.on_change(name, [&changes, name](ArgParser&, ArgParser&) {
+            changes.push_back(name);
+        });
+    }
+
+    // No result is held between reloads, so from the third one on the replaced parser is parsed into.
+    ASSERT_TRUE(watcher.reload());
+    std::ofstream(path) << "level=1\nname=b\n";
+    ASSERT_TRUE(watcher.reload());
+    std::ofstream(path) << "level=2\nname=b\n";
+    ASSERT_TRUE(watcher.reload());
+    ASSERT_EQ(watcher.get_result()->get_string_value("name"), "b");
+    ASSERT_EQ(watcher.get_result()->get_int_value("level"), 2);
+
+    std::ofstream(path) << "level=x\nname=c\n";
+    ASSERT_FALSE(watcher.reload());
+    ASSERT_EQ(watcher.get_result()->get_string_value("name"), "b");
+
+    std::ofstream(path) << "level=3\nname=c\n";
+    ASSERT_TRUE(watcher.reload());
+    ASSERT_EQ(watcher.get_result()->get_string_value("name"), "c");
+    ASSERT_EQ(watcher.get_result()->get_int_value("level"), 3);
+    ASSERT_EQ(changes, std::vector<std::string>({"name", "level", "level", "name"}));
+}
+
+
+TEST(ArgParserTestSuite, ConfigWatcherAbbreviationTest) {
+    std::string path = get_temp_path("config.conf");
+    std::ofstream(path) << "include=a\nincl=b\nlevel=1\n";
+
+    std::ostringstream errors;
+    ConfigWatcher watcher([&errors] {
+        auto parser = std::make_unique<ArgParser>("Daemon");
+        parser->set_allow_abbreviations(true);
+        parser->set_error_stream(&errors);
+        parser->add_string_argument("include").mark_multi_value();
+        parser->add_int_argument("level");
+        return parser;
+    }, {"daemon"}, path);
+
+    ASSERT_TRUE(watcher.reload());
+    ASSERT_EQ(watcher.get_result()->get_argument<StringArgument>("include").get_value_count(), 2);
+
+    // Both spellings set include, so changing one line parses the other one again too.
+    std::ofstream(path) << "include=a\nincl=c\nlevel=1\n";
+    ASSERT_TRUE(watcher.reload());
+    ASSERT_EQ(watcher.get_result()->get_argument<StringArgument>("include").get_value_count(), 2);
+    ASSERT_EQ(watcher.get_result()->get_string_value("include", 0), "a");
+    ASSERT_EQ(watcher.get_result()->get_string_value("include", 1), "c");
+
+    std::ofstream(path) << "include=a\nincl=c\nlevel=1\nlvl=2\n";
+    ASSERT_FALSE(watcher.reload());
+    ASSERT_NE(errors.str().find("Unknown argument name: lvl"), std::string::npos);
+    ASSERT_EQ(watcher.get_result()->get_int_value("level"), 1);
+}
+
+
+TEST(ArgParserTestSuite, BatchParserTest) {
+    BatchParser batch_parser([] {
+        auto parser = std::make_unique<ArgParser>("Job");
+        parser->add_int_argument("level");
+        parser->add_flag('v', "verbose");
+        return parser;
+    }, [](ArgParser& parser, std::string& output) {
+        output += std::to_string(parser.get_int_value("level"));
+    });
+    batch_parser.set_thread_count(2);
+    batch_parser.set_chunk_size(2);
+
+    std::string output;
+    batch_parser.parse_lines("job --level=1\njob -v --level=2\njob -v\n\njob --level 5\r\n", output);
+    ASSERT_EQ(output, "1\n2\nerror: Parsing error: argument value not found. Argument name: level\nerror: Parsing error: argument value not found. Argument name: level\n5\n");
+    ASSERT_EQ(batch_parser.get_stats().line_count, 5);
+    ASSERT_EQ(batch_parser.get_stats().error_count, 2);
+
+    // Written chunk by chunk in input order, whichever worker parses a chunk first.
+    std::string input_path = get_temp_path("input.txt");
+    std::string input;
+    for (int i = 0; i < 100; i++) {
+        input += "job --level=" + std::to_string(i) + "\n";
+    }
+    std::ofstream(input_path) << input;
+
+    ASSERT_TRUE(batch_parser.parse_file(input_path.c_str(), (input_path + ".out").c_str()));
+    batch_parser.parse_lines(input, output);
+    std::ifstream output_file(input_path + ".out");
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(output_file), std::istreambuf_iterator<char>()), output);
+    ASSERT_EQ(batch_parser.get_stats().line_count, 100);
+
+    std::ostringstream errors;
+    batch_parser.set_error_stream(&errors);
+    std::string missing_path = get_temp_path("missing.txt");
+    ASSERT_FALSE(batch_parser.parse_file(missing_path.c_str(), (missing_path + ".out").c_str()));
+    ASSERT_EQ(errors.str(), "Batch error: cannot open input file: " + missing_path + "\n");
+}
+
+
+TEST(ArgParserTestSuite, FileArgumentTest) {
+    std::string path = get_temp_path("input.txt");
+    std::ofstream(path) << "contents";
+
+    ArgParser parser("My Parser");
+    FileArgument& input = parser.add_file_argument('i', "input", "Input file");
+    std::vector<MappedFile> files;
+    parser.add_file_argument("Files").mark_multi_value().mask_positional().store_values(files);
+
+    ASSERT_TRUE(parser.parse(std::vector<std::string>{"app", "-i", path, path, path}));
+    std::span<const std::byte> data = parser.get_file_value("input").data();
+    ASSERT_EQ(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()), "contents");
+    ASSERT_EQ(input.get_value_count(), 0);
+    ASSERT_EQ(files.size(), 2);
+    ASSERT_EQ(files[1].path(), path);
+    ASSERT_EQ(files[1].data().size(), 8);
+
+    std::ostringstream errors;
+    parser.set_error_stream(&errors);
+    ASSERT_FALSE(parser.parse(std::vector<std::string>{"app", "-i", path + ".missing"}));
+    ASSERT_EQ(errors.str(), "Parsing error: cannot open file '" + path + ".missing': No such file or directory\n");
+}
+
+
+TEST(ArgParserTestSuite, ValidatorTest) {
+    ArgParser parser("My Parser");
+    auto is_even = [](const int& value, std::string& error) {
+        error = "value is odd";
+        return value % 2 == 0;
+    };
+    parser.add_int_argument("first").set_validator(is_even);
+    parser.add_int_argument("second").set_default_value(1).set_validator(is_even);
+    parser.add_int_argument("Values").mark_multi_value().mask_positional().set_validator(is_even);
+    parser.set_concurrent_validation(true);
+
+    ASSERT_TRUE(parser.parse(split_string("app --first=2 4 6")));
+    ASSERT_EQ(parser.get_validation_results().size(), 2);
+
+    ASSERT_FALSE(parser.parse(split_string("app --first=3 --second=2 4 5")));
+    const std::vector<ValidationResult>& results = parser.get_validation_results();
+    ASSERT_EQ(results.size(), 3);
+    ASSERT_STREQ(results[0].argument_name, "first");
+    ASSERT_FALSE(results[0].is_valid);
+    ASSERT_TRUE(results[1].is_valid);
+    ASSERT_FALSE(results[2].is_valid);
+    ASSERT_EQ(results[2].error, "value is odd");
+}
+
+
+TEST(ArgParserTestSuite, ValidatorTimeoutTest) {
+    ArgParser parser("My Parser");
+    parser.add_int_argument("delay").set_validator([](const int& delay, std::string& error) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        return true;
+    });
+    parser.set_validation_timeout(std::chrono::milliseconds(20));
+
+    ASSERT_TRUE(parser.parse(split_string("app --delay=0")));
+    ASSERT_FALSE(parser.parse(split_string("app --delay=40")));
+    ASSERT_TRUE(parser.get_validation_results()[0].is_timed_out);
+
+    parser.set_concurrent_validation(true);
+    ASSERT_FALSE(parser.parse(split_string("app --delay=40")));
+    ASSERT_TRUE(parser.get_validation_results()[0].is_timed_out);
+    ASSERT_EQ(parser.get_validation_results()[0].duration, std::chrono::milliseconds(20));
+
+    // The timed out validator keeps running, and the parser waits for it when destroyed.
+    std::atomic<bool> is_finished = false;
+    {
+        ArgParser waiting_parser("My Parser");
+        waiting_parser.add_int_argument("delay").set_validator([&is_finished](const int& delay, std::string& error) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            is_finished = true;
+            return true;
+        });
+        waiting_parser.set_validation_timeout(std::chrono::milliseconds(20));
+        waiting_parser.set_concurrent_validation(true);
+        ASSERT_FALSE(waiting_parser.parse(split_string("app --delay=40")));
+        ASSERT_FALSE(is_finished);
+    }
+
+    ASSERT_TRUE(is_finished);
+}
+
+
+TEST(ArgParserTestSuite, CaptureLogTest) {
+    std::string path = get_temp_path("capture.bin");
+    std::remove(path.c_str());
+
+    std::vector<std::string> first = split_string("app --param1=value1 2");
+    std::vector<std::string> second = split_string("app");
+    std::ostringstream errors;
+    std::string missing_path = get_temp_path("missing_directory/capture.bin");
+    ASSERT_FALSE(CaptureLog(missing_path.c_str(), errors).is_open());
+    ASSERT_EQ(errors.str(), "Capture error: cannot open capture log: " + missing_path + "\n");
+
+    {
+        CaptureLog log(path.c_str(), errors);
+        ASSERT_TRUE(log.is_open());
+        log.append(std::span<const std::string>(first), std::chrono::nanoseconds(1500), true);
+        log.append(std::span<const std::string>(second), std::chrono::nanoseconds(300), false);
+    }
+
+    std::vector<CapturedCommandLine> command_lines;
+    ASSERT_TRUE(CaptureLog::read(path.c_str(), command_lines));
+    ASSERT_EQ(command_lines.size(), 2);
+    ASSERT_EQ(command_lines[0].tokens, first);
+    ASSERT_EQ(command_lines[0].latency, std::chrono::nanoseconds(1500));
+    ASSERT_TRUE(command_lines[0].is_successful);
+    ASSERT_EQ(command_lines[1].tokens, second);
+    ASSERT_FALSE(command_lines[1].is_successful);
+}
+
+
+// Parses once in the current process and once in a forked child, which flushes its own record at exit.
+void capture_in_forked_child(const std::string& path) {
+    setenv(CAPTURE_LOG_VARIABLE, path.c_str(), 1);
+
+    ArgParser parser("My Parser");
+    parser.add_int_argument("level");
+    parser.parse(split_string("app --level=1"));
+
+    pid_t child = fork();
+    if (child == 0) {
+        parser.parse(split_string("app --level=2"));
+        std::exit(0);
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    std::exit(WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+}
+
+
+TEST(ArgParserTestSuite, CaptureLogForkTest) {
+#ifdef ARGPARSER_LEAK_CHECK
+    // The leak check at exit never finishes in a forked child of a process with threads.
+    GTEST_SKIP();
+#endif
+
+    std::string path = get_temp_path("capture.bin");
+    std::remove(path.c_str());
+
+    // The threadsafe style runs the statement in a new process, whose capture log is not opened yet.
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    ASSERT_EXIT(capture_in_forked_child(path), testing::ExitedWithCode(0), "");
+
+    std::vector<CapturedCommandLine> command_lines;
+    ASSERT_TRUE(CaptureLog::read(path.c_str(), command_lines));
+    ASSERT_EQ(command_lines.size(), 2);
+
+    std::vector<std::string> levels = {command_lines[0].tokens[1], command_lines[1].tokens[1]};
+    std::sort(levels.begin(), levels.end());
+    ASSERT_EQ(levels, std::vector<std::string>({"--level=1", "--level=2"}));
+}
+
+
+TEST(ArgParserTestSuite, ArgumentHandleTest) {
+    ArgParser parser("My Parser");
+    ArgumentHandle<int> level = parser.add_int_argument("level").set_default_value(1).handle();
+    ArgumentHandle<std::string> output = parser.add_string_argument('o', "output").handle();
+    ArgumentHandle<bool> verbose = parser.add_flag('v', "verbose").handle();
+    ArgumentHandle<int> values = parser.add_int_argument("Values").mark_multi_value().mask_positional().handle();
+
+    ASSERT_TRUE(parser.parse(split_string("app -o=file -v 5 7")));
+    ASSERT_EQ(parser[level], 1);
+    ASSERT_EQ(parser[output], "file");
+    ASSERT_TRUE(parser[verbose]);
+    ASSERT_EQ(parser.get_value(values, 1), 7);
+
+    ASSERT_TRUE(parser.parse(split_string("app -o=other --level=3")));
+    ASSERT_EQ(parser[level], 3);
+    ASSERT_FALSE(parser[verbose]);
+}
+
+
+TEST(ArgParserTestSuite, ArgumentHandleEdgeCaseTest) {
+    ArgParser parser("My Parser");
+    std::vector<bool> flags;
+    ArgumentHandle<bool> flag = parser.add_flag('f', "flag").mark_multi_value().store_values(flags).handle();
+    ArgumentHandle<int> level = parser.add_int_argument("level").handle();
+
+    ASSERT_TRUE(parser.parse(split_string("app -f -f --level=2")));
+    ASSERT_EQ(flags.size(), 2);
+    ASSERT_TRUE(parser.get_value(flag, 1));
+
+    // The failed parse leaves level without a value, and it has no default.
+    ASSERT_FALSE(parser.parse(split_string("app")));
+    ASSERT_DEATH(parser[level], "neither a parsed nor a default value. Argument name: level");
+}
+
+
+TEST(ArgParserTestSuite, DelimitedMultiValueTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> ids;
+    parser.add_int_argument("ids").mark_multi_value(1, 0, ',').store_values(ids);
+    parser.add_string_argument("names").mark_multi_value(0, 0, ':');
+
+    std::string token = "--ids=-2147483648";
+    std::vector<int> expected = {-2147483648};
+    for (int i = 0; i < 40; i++) {
+        expected.push_back(i * 123457);
+        token += "," + std::to_string(expected.back());
+    }
+
+    ASSERT_TRUE(parser.parse(std::vector<std::string>{"app", token, "--ids=7", "--names=a::b"}));
+    expected.push_back(7);
+    ASSERT_EQ(ids, expected);
+    ASSERT_EQ(parser.get_string_value("names", 0), "a");
+    ASSERT_EQ(parser.get_string_value("names", 1), "");
+    ASSERT_EQ(parser.get_string_value("names", 2), "b");
+
+    ASSERT_FALSE(parser.parse(split_string("app --ids=1,,2")));
+    ASSERT_FALSE(parser.parse(split_string("app --ids=1,2147483648")));
+    ASSERT_FALSE(parser.parse(split_string("app --ids=1,12345678x")));
+
+    // Over 19 digits, only leading zeros keep the value in range.
+    ASSERT_TRUE(parser.parse(split_string("app --ids=1,-0000000000000000000042")));
+    ASSERT_EQ(ids.back(), -42);
+    ASSERT_FALSE(parser.parse(split_string("app --ids=1,18446744073709551616")));
+    ASSERT_FALSE(parser.parse(split_string("app --ids=1,00000000000000000000x")));
+}
+
+
 TEST(ArgParserTestSuite, RepeatedParsingTest) {
     ArgParser parser("My Parser");
     parser.add_help('h', "help", "Some Description about program");
@@ -184,6 +978,98 @@ TEST(ArgParserTestSuite, RepeatedParsingTest) {
 }
 
 
+TEST(ArgParserTestSuite, SnapshotTest) {
+    auto build_parser = [](ArgParser& parser, std::vector<int>& values) {
+        parser.add_string_argument('i', "input");
+        parser.add_int_argument("number").set_default_value(7);
+        parser.add_choice_argument<MODES>("mode").set_default_value(Mode::Fast);
+        parser.add_flag('v', "verbose");
+        parser.add_int_argument("N").mark_multi_value(1).mask_positional().store_values(values);
+    };
+
+    std::vector<int> master_values;
+    ArgParser master("My Parser");
+    build_parser(master, master_values);
+    ASSERT_TRUE(master.parse(split_string("app -i a-value-that-does-not-fit-into-sso-storage --mode=debug -v 1 2 3")));
+
+    std::vector<std::byte> snapshot;
+    ASSERT_TRUE(master.save_snapshot(snapshot));
+
+    std::vector<int> worker_values;
+    ArgParser worker("My Parser");
+    build_parser(worker, worker_values);
+    ASSERT_TRUE(worker.restore_snapshot(snapshot));
+
+    ASSERT_EQ(worker.get_string_value("input"), "a-value-that-does-not-fit-into-sso-storage");
+    ASSERT_EQ(worker.get_int_value("number"), 7);
+    ASSERT_EQ(worker.get_argument_value<Mode>("mode"), Mode::Debug);
+    ASSERT_TRUE(worker.get_flag("verbose"));
+    ASSERT_EQ(worker_values, master_values);
+
+    ArgParser other("Other Parser");
+    other.add_string_argument('i', "input");
+    ASSERT_FALSE(other.restore_snapshot(snapshot));
+
+    // A truncated snapshot leaves the values of the last parse in place.
+    ASSERT_TRUE(worker.parse(split_string("app -i b 4")));
+    snapshot.resize(snapshot.size() - 1);
+    ASSERT_FALSE(worker.restore_snapshot(snapshot));
+    ASSERT_EQ(worker.get_string_value("input"), "b");
+    ASSERT_FALSE(worker.get_flag("verbose"));
+    ASSERT_EQ(worker_values, std::vector<int>({1, 2, 3, 4}));
+}
+
+
+TEST(ArgParserTestSuite, ParseCacheTest) {
+    ArgParser parser("My Parser");
+    parser.enable_parse_cache(2);
+    parser.add_int_argument('n', "number");
+    parser.add_int_argument("N").mark_multi_value(1).mask_positional();
+
+    ASSERT_TRUE(parser.parse(split_string("app -n 1 10 20")));
+    ASSERT_TRUE(parser.parse(split_string("app -n 2 30")));
+    ASSERT_TRUE(parser.parse(split_string("app -n 1 10 20")));
+    ASSERT_EQ(parser.get_int_value("number"), 1);
+    ASSERT_EQ(parser.get_argument<IntArgument>("N").get_value_count(), 2);
+    ASSERT_EQ(parser.get_int_value("N", 1), 20);
+
+    ASSERT_TRUE(parser.parse(split_string("app -n 3 40")));
+    ASSERT_TRUE(parser.parse(split_string("app -n 2 30")));
+    ASSERT_EQ(parser.get_int_value("number"), 2);
+    ASSERT_EQ(parser.get_argument<IntArgument>("N").get_value_count(), 1);
+
+    ASSERT_FALSE(parser.parse(split_string("app -n x 30")));
+
+    ParseCacheStats stats = parser.get_parse_cache_stats();
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.misses, 5);
+}
+
+
+TEST(ArgParserTestSuite, StoreValuesAppendTest) {
+    // Hits and misses of the cache append to the stored vector like an uncached parse.
+    for (bool is_cached : {false, true}) {
+        ArgParser parser("My Parser");
+        std::vector<int> values;
+        if (is_cached) {
+            parser.enable_parse_cache(2);
+        }
+        parser.add_int_argument("N").mark_multi_value(1).mask_positional().store_values(values);
+        std::vector<int> counts;
+        parser.add_int_argument("count").mark_multi_value(1).store_values(counts);
+
+        ASSERT_TRUE(parser.parse(split_string("app --count=1 10 20")));
+        ASSERT_TRUE(parser.parse(split_string("app --count=2 30")));
+        ASSERT_TRUE(parser.parse(split_string("app --count=1 10 20")));
+        ASSERT_EQ(values, std::vector<int>({10, 20, 30, 10, 20}));
+        ASSERT_EQ(counts, std::vector<int>({1, 2, 1}));
+
+        // The minimum count is checked against the values of this parse only.
+        ASSERT_FALSE(parser.parse(split_string("app 40")));
+    }
+}
+
+
 TEST(ArgParserTestSuite, HelpTest) {
     ArgParser parser("My Parser");
     parser.add_help('h', "help", "Some Description about program");
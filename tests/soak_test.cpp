@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <argparser.h>
+
+using namespace ArgumentParser;
+
+/*
+    Строит и разбирает большой парсер много раз подряд и проверяет,
+    что резидентная память процесса не растет
+*/
+namespace {
+
+enum class Codec {
+    Raw,
+    Gzip,
+    Zstd,
+};
+
+constexpr auto CODECS = make_choice_table<Codec>({
+    {"raw", Codec::Raw},
+    {"gzip", Codec::Gzip},
+    {"zstd", Codec::Zstd},
+});
+
+constexpr size_t OPTION_GROUP_COUNT = 8;
+
+size_t get_resident_memory() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    statm >> total_pages >> resident_pages;
+
+    return resident_pages * 4096;
+}
+
+size_t get_iteration_count() {
+    const char* iterations = std::getenv("ARGPARSER_SOAK_ITERATIONS");
+    if (iterations == nullptr) {
+        return 1000000;
+    }
+
+    return std::strtoull(iterations, nullptr, 10);
+}
+
+std::vector<std::string> make_arguments() {
+    std::vector<std::string> arguments = {"app", "--help", "-v"};
+
+    for (size_t i = 0; i < OPTION_GROUP_COUNT; i++) {
+        std::string suffix = std::to_string(i);
+        arguments.push_back("--string" + suffix + "=a-value-that-does-not-fit-into-sso-storage");
+        arguments.push_back("--int" + suffix + "=" + suffix);
+        arguments.push_back("--list" + suffix + "=1");
+        arguments.push_back("--list" + suffix + "=2");
+        arguments.push_back("--codec" + suffix + "=zstd");
+    }
+
+    for (size_t i = 0; i < 32; i++) {
+        arguments.push_back(std::to_string(i));
+    }
+
+    return arguments;
+}
+
+void build_and_parse(const std::vector<std::string>& arguments, std::vector<std::string>& names) {
+    ArgParser parser("Soak Parser");
+    parser.add_help('h', "help", "Large parser");
+    parser.add_flag('v', "verbose", "Verbose output");
+    parser.add_int_argument("N").mark_multi_value(1).mask_positional();
+
+    for (size_t i = 0; i < OPTION_GROUP_COUNT; i++) {
+        parser.add_string_argument(names[i * 5].c_str(), "String option");
+        parser.add_int_argument(names[i * 5 + 1].c_str(), "Int option");
+        parser.add_int_argument(names[i * 5 + 2].c_str(), "List option").mark_multi_value();
+        parser.add_choice_argument<CODECS>(names[i * 5 + 3].c_str(), "Codec option");
+        parser.add_flag(names[i * 5 + 4].c_str(), "Unused flag");
+    }
+
+    ASSERT_TRUE(parser.parse(arguments));
+    ASSERT_FALSE(parser.get_help_description().empty());
+}
+
+} // namespace
+
+
+TEST(ArgParserSoakTestSuite, FlatResidentMemoryTest) {
+    std::vector<std::string> arguments = make_arguments();
+    std::vector<std::string> names;
+
+    for (size_t i = 0; i < OPTION_GROUP_COUNT; i++) {
+        std::string suffix = std::to_string(i);
+        names.push_back("string" + suffix);
+        names.push_back("int" + suffix);
+        names.push_back("list" + suffix);
+        names.push_back("codec" + suffix);
+        names.push_back("unused" + suffix);
+    }
+
+    size_t iteration_count = get_iteration_count();
+    size_t warmup_count = std::max<size_t>(1, iteration_count / 100);
+
+    for (size_t i = 0; i < warmup_count; i++) {
+        build_and_parse(arguments, names);
+    }
+
+    size_t resident_memory_before = get_resident_memory();
+
+    for (size_t i = warmup_count; i < iteration_count; i++) {
+        build_and_parse(arguments, names);
+    }
+
+    size_t resident_memory_after = get_resident_memory();
+
+    // Allow allocator noise, but not per-iteration growth.
+    ASSERT_LE(resident_memory_after, resident_memory_before + 1024 * 1024);
+}